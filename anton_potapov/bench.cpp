@@ -0,0 +1,172 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+#include "graph_generator.hpp"
+
+namespace {
+
+// The yellow pass compares every chosen vertex with its whole next layer,
+// graphs expected to be larger take too long to build again and again.
+constexpr double MAX_EXPECTED_VERTICES_NUM = 1 << 10;
+constexpr int IS_CONNECTED_QUERIES_NUM = 1 << 12;
+
+using ColorPass = void (*)(Graph&);
+
+// Every vertex at depth d has Binomial(new_vertices_num, 1 - d / depth)
+// children, as `generate_vertices` draws them.
+double get_expected_vertices_num(int depth, int new_vertices_num) {
+  double layer_size = 1;
+  double vertices_num = 1;
+  for (int current_depth = 0; current_depth < depth; current_depth++) {
+    layer_size *=
+        new_vertices_num * (1.0 - static_cast<double>(current_depth) / depth);
+    vertices_num += layer_size;
+  }
+  return vertices_num;
+}
+
+// Depths 2..14 by new_vertices_num 1..10, without the ones too large.
+void add_graph_sizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"depth", "new_vertices"});
+  for (int depth = 2; depth <= 14; depth += 3)
+    for (const int new_vertices_num : {1, 2, 4, 7, 10})
+      if (get_expected_vertices_num(depth, new_vertices_num) <=
+          MAX_EXPECTED_VERTICES_NUM)
+        benchmark->Args({depth, new_vertices_num});
+}
+
+GraphGenerator::Params get_params(const benchmark::State& state) {
+  return GraphGenerator::Params(state.range(0), state.range(1));
+}
+
+Graph generate_gray_tree(const benchmark::State& state) {
+  Graph graph;
+  generate_vertices(graph, state.range(0), state.range(1));
+  return graph;
+}
+
+// Edge ids are given out in order from 0.
+int get_edges_num(const Graph& graph) {
+  EdgeId max_edge_id = -1;
+  for (const auto& [vertex_id, vertex] : graph.vertices())
+    if (!vertex.connected_edges().empty())
+      max_edge_id = std::max(max_edge_id, *vertex.connected_edges().rbegin());
+  return max_edge_id + 1;
+}
+
+void set_graph_counters(benchmark::State& state,
+                        int64_t vertices_num,
+                        int64_t edges_num) {
+  state.counters["vertices/s"] =
+      benchmark::Counter(vertices_num, benchmark::Counter::kIsRate);
+  state.counters["edges/s"] =
+      benchmark::Counter(edges_num, benchmark::Counter::kIsRate);
+}
+
+void BM_Generate(benchmark::State& state) {
+  const auto graph_generator = GraphGenerator(get_params(state));
+  int64_t vertices_num = 0;
+  int64_t edges_num = 0;
+  for (auto _ : state) {
+    const auto graph = graph_generator.generate_graph();
+    vertices_num += graph.vertices().size();
+    edges_num += get_edges_num(graph);
+  }
+  set_graph_counters(state, vertices_num, edges_num);
+}
+BENCHMARK(BM_Generate)->Apply(add_graph_sizes);
+
+void BM_GrayTree(benchmark::State& state) {
+  int64_t vertices_num = 0;
+  for (auto _ : state) {
+    const auto graph = generate_gray_tree(state);
+    vertices_num += graph.vertices().size();
+  }
+  set_graph_counters(state, vertices_num, vertices_num - state.iterations());
+}
+BENCHMARK(BM_GrayTree)->Apply(add_graph_sizes);
+
+// A pass adds to the edges before it, so each iteration gets a gray tree of
+// its own, built with the clock stopped.
+void run_color_pass(benchmark::State& state, ColorPass color_pass) {
+  int64_t vertices_num = 0;
+  int64_t edges_num = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto graph = generate_gray_tree(state);
+    const int gray_edges_num = get_edges_num(graph);
+    state.ResumeTiming();
+    color_pass(graph);
+    state.PauseTiming();
+    vertices_num += graph.vertices().size();
+    edges_num += get_edges_num(graph) - gray_edges_num;
+    state.ResumeTiming();
+  }
+  set_graph_counters(state, vertices_num, edges_num);
+}
+
+void BM_PaintGreen(benchmark::State& state) {
+  run_color_pass(state, generate_green_edges);
+}
+BENCHMARK(BM_PaintGreen)->Apply(add_graph_sizes);
+
+void BM_PaintBlue(benchmark::State& state) {
+  run_color_pass(state, generate_blue_edges);
+}
+BENCHMARK(BM_PaintBlue)->Apply(add_graph_sizes);
+
+void BM_PaintYellow(benchmark::State& state) {
+  run_color_pass(state, generate_yellow_edges);
+}
+BENCHMARK(BM_PaintYellow)->Apply(add_graph_sizes);
+
+void BM_PaintRed(benchmark::State& state) {
+  run_color_pass(state, generate_red_edges);
+}
+BENCHMARK(BM_PaintRed)->Apply(add_graph_sizes);
+
+void BM_IsConnected(benchmark::State& state) {
+  const auto graph = GraphGenerator(get_params(state)).generate_graph();
+  const int vertices_num = graph.vertices().size();
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<VertexId> vertex_id(0, vertices_num - 1);
+  std::vector<std::pair<VertexId, VertexId>> queries;
+  for (int i = 0; i < IS_CONNECTED_QUERIES_NUM; i++)
+    queries.emplace_back(vertex_id(rng), vertex_id(rng));
+
+  int query = 0;
+  for (auto _ : state) {
+    const auto& [vertex1_id, vertex2_id] = queries[query];
+    benchmark::DoNotOptimize(graph.is_connected(vertex1_id, vertex2_id));
+    query = (query + 1) % IS_CONNECTED_QUERIES_NUM;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IsConnected)->Apply(add_graph_sizes);
+
+void BM_PrintGraph(benchmark::State& state) {
+  auto graph = GraphGenerator(get_params(state)).generate_graph();
+  // Settles the depths, so the timed calls only print.
+  graph.get_json_string();
+  const auto& const_graph = graph;
+  const int64_t vertices_num = graph.vertices().size();
+  const int64_t edges_num = get_edges_num(graph);
+  int64_t printed_size = 0;
+  for (auto _ : state)
+    printed_size += const_graph.get_json_string().size();
+  set_graph_counters(state, vertices_num * state.iterations(),
+                     edges_num * state.iterations());
+  state.SetBytesProcessed(printed_size);
+}
+BENCHMARK(BM_PrintGraph)->Apply(add_graph_sizes);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define BERNOULLI_MASK_AVX2
+#endif
+
+namespace uni_cpp_practice {
+
+// Bernoulli trials with one probability filled a whole layer at a time. Bit
+// `i % 64` of word `i / 64` is set when trial `i` succeeded.
+namespace bernoulli_mask {
+
+using Mask = std::vector<uint64_t>;
+
+namespace detail {
+
+constexpr uint32_t HASH_MULTIPLIER_1 = 0x7feb352d;
+constexpr uint32_t HASH_MULTIPLIER_2 = 0x846ca68b;
+
+inline uint32_t hash(uint32_t value) {
+  value ^= value >> 16;
+  value *= HASH_MULTIPLIER_1;
+  value ^= value >> 15;
+  value *= HASH_MULTIPLIER_2;
+  value ^= value >> 16;
+  return value;
+}
+
+// Counter based: the draw of trial `counter` is a pure function of `key` and
+// `counter`, so any number of trials can be computed side by side.
+inline uint32_t get_random(uint64_t key, uint32_t counter) {
+  return hash(hash(counter ^ static_cast<uint32_t>(key)) ^
+              static_cast<uint32_t>(key >> 32));
+}
+
+inline void fill_scalar(uint64_t* words,
+                        size_t trials_num,
+                        uint32_t threshold,
+                        uint64_t key,
+                        uint32_t first_counter) {
+  for (size_t i = 0; i < trials_num; i++)
+    if (get_random(key, first_counter + static_cast<uint32_t>(i)) < threshold)
+      words[i / 64] |= uint64_t{1} << (i % 64);
+}
+
+#ifdef BERNOULLI_MASK_AVX2
+
+__attribute__((target("avx2"))) inline __m256i hash_avx2(__m256i value) {
+  const __m256i multiplier_1 =
+      _mm256_set1_epi32(static_cast<int>(HASH_MULTIPLIER_1));
+  const __m256i multiplier_2 =
+      _mm256_set1_epi32(static_cast<int>(HASH_MULTIPLIER_2));
+  value = _mm256_xor_si256(value, _mm256_srli_epi32(value, 16));
+  value = _mm256_mullo_epi32(value, multiplier_1);
+  value = _mm256_xor_si256(value, _mm256_srli_epi32(value, 15));
+  value = _mm256_mullo_epi32(value, multiplier_2);
+  return _mm256_xor_si256(value, _mm256_srli_epi32(value, 16));
+}
+
+// Eight trials per step and 64 per word, the tail goes through the scalar
+// loop. AVX2 has no unsigned compare, both sides are shifted by 2^31.
+__attribute__((target("avx2"))) inline void fill_avx2(uint64_t* words,
+                                                      size_t trials_num,
+                                                      uint32_t threshold,
+                                                      uint64_t key,
+                                                      uint32_t first_counter) {
+  const __m256i key_low = _mm256_set1_epi32(static_cast<int>(key));
+  const __m256i key_high = _mm256_set1_epi32(static_cast<int>(key >> 32));
+  const __m256i sign_bit = _mm256_set1_epi32(INT32_MIN);
+  const __m256i biased_threshold = _mm256_xor_si256(
+      _mm256_set1_epi32(static_cast<int>(threshold)), sign_bit);
+  const __m256i lane_offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+  const size_t full_words_num = trials_num / 64;
+  for (size_t word = 0; word < full_words_num; word++) {
+    uint64_t bits = 0;
+    for (int step = 0; step < 8; step++) {
+      const uint32_t counter =
+          first_counter + static_cast<uint32_t>(word * 64 + step * 8);
+      __m256i value = _mm256_add_epi32(
+          _mm256_set1_epi32(static_cast<int>(counter)), lane_offsets);
+      value = hash_avx2(_mm256_xor_si256(value, key_low));
+      value = hash_avx2(_mm256_xor_si256(value, key_high));
+      const __m256i is_success = _mm256_cmpgt_epi32(
+          biased_threshold, _mm256_xor_si256(value, sign_bit));
+      const auto step_bits = static_cast<uint32_t>(
+          _mm256_movemask_ps(_mm256_castsi256_ps(is_success)));
+      bits |= static_cast<uint64_t>(step_bits) << (step * 8);
+    }
+    words[word] = bits;
+  }
+
+  const size_t done_trials_num = full_words_num * 64;
+  fill_scalar(words + full_words_num, trials_num - done_trials_num, threshold,
+              key, first_counter + static_cast<uint32_t>(done_trials_num));
+}
+
+inline bool has_avx2() {
+  static const bool is_supported = __builtin_cpu_supports("avx2");
+  return is_supported;
+}
+
+#endif
+
+}  // namespace detail
+
+// Fills `mask` with `trials_num` trials succeeding with `probability`, trial
+// `i` drawn from counter `first_counter + i` of stream `key`.
+inline void fill(Mask& mask,
+                 size_t trials_num,
+                 double probability,
+                 uint64_t key,
+                 uint32_t first_counter = 0) {
+  mask.assign((trials_num + 63) / 64, 0);
+  if (probability <= 0)
+    return;
+  if (probability >= 1) {
+    for (size_t i = 0; i < trials_num; i++)
+      mask[i / 64] |= uint64_t{1} << (i % 64);
+    return;
+  }
+
+  const auto threshold = static_cast<uint32_t>(probability * 0x1.0p32);
+#ifdef BERNOULLI_MASK_AVX2
+  if (detail::has_avx2())
+    return detail::fill_avx2(mask.data(), trials_num, threshold, key,
+                             first_counter);
+#endif
+  detail::fill_scalar(mask.data(), trials_num, threshold, key, first_counter);
+}
+
+inline bool test(const Mask& mask, size_t index) {
+  return (mask[index / 64] >> (index % 64)) & 1;
+}
+
+// Calls `on_success(i)` for every succeeded trial, in increasing order.
+template <typename OnSuccess>
+void for_each_success(const Mask& mask, const OnSuccess& on_success) {
+  for (size_t word = 0; word < mask.size(); word++)
+    for (uint64_t bits = mask[word]; bits != 0; bits &= bits - 1)
+      on_success(word * 64 + __builtin_ctzll(bits));
+}
+
+}  // namespace bernoulli_mask
+
+}  // namespace uni_cpp_practice
@@ -1,30 +1,45 @@
 #pragma once
 
+#include <cstdint>
+#include <random>
+
 #include "graph.hpp"
+#include "random_engine.hpp"
 
 namespace uni_cpp_practice {
 class GraphGenerator {
  public:
   struct Params {
-    explicit Params(int init_depth = 0, int init_new_vertices_num = 0)
-        : depth(init_depth), new_vertices_num(init_new_vertices_num) {}
+    explicit Params(int init_depth = 0,
+                    int init_new_vertices_num = 0,
+                    uint64_t init_seed = std::random_device{}())
+        : depth(init_depth),
+          new_vertices_num(init_new_vertices_num),
+          seed(init_seed) {}
 
     const int depth = 0;
     const int new_vertices_num = 0;
+    // Graphs generated with the same params and `graph_num` are the same.
+    const uint64_t seed = 0;
   };
 
   explicit GraphGenerator(const Params& params = Params()) : params_(params) {}
 
-  Graph generate_random_graph() const;
+  Graph generate_random_graph(int graph_num = 0) const;
 
  private:
+  using Engine = random_engine::Engine;
+
   const Params params_ = Params();
 
-  void generate_grey_edges(Graph& graph, int depth, int new_vertices_num) const;
+  void generate_grey_edges(Graph& graph,
+                           int depth,
+                           int new_vertices_num,
+                           Engine& engine) const;
 
-  void generate_green_edges(Graph& graph) const;
-  void generate_blue_edges(Graph& graph) const;
-  void generate_yellow_edges(Graph& graph) const;
-  void generate_red_edges(Graph& graph) const;
+  void generate_green_edges(Graph& graph, Engine& engine) const;
+  void generate_blue_edges(Graph& graph, Engine& engine) const;
+  void generate_yellow_edges(Graph& graph, Engine& engine) const;
+  void generate_red_edges(Graph& graph, Engine& engine) const;
 };
 }  // namespace uni_cpp_practice
@@ -1,24 +1,78 @@
 #pragma once
 
-#include <fstream>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <thread>
 
 namespace uni_cpp_practice {
+// Records are queued into a lock-free ring and written to stdout and the
+// log file by a background thread, so `log` never waits for the terminal
+// or the disk.
 class Logger {
  public:
+  // What `log` does when the ring is full.
+  enum class OverflowPolicy { Block, Drop };
+
   static Logger& get_instance() {
     static Logger instance;
     return instance;
   }
 
   void set_file(const std::optional<std::string>& filename);
-  void log(const std::string& string);
+
+  void log(std::string string);
+
+  void set_overflow_policy(const OverflowPolicy& policy) {
+    overflow_policy_ = policy;
+  }
+
+  // Blocks until every record logged before the call is written.
+  void flush();
+
   ~Logger();
 
  private:
-  std::optional<std::ofstream> file_stream_;
+  static constexpr size_t RING_SIZE = 1 << 12;
+
+  // `sequence` tells whose turn the slot is: equal to the position for the
+  // producer that will fill it, one past it for the flush thread.
+  struct Slot {
+    std::atomic<uint64_t> sequence;
+    std::string text;
+  };
+
+  std::array<Slot, RING_SIZE> ring_;
+  std::atomic<uint64_t> enqueue_position_ = 0;
+  // Owned by the flush thread.
+  uint64_t dequeue_position_ = 0;
+  std::atomic<OverflowPolicy> overflow_policy_ = OverflowPolicy::Block;
+  std::atomic<uint64_t> dropped_records_ = 0;
+
+  // Guards the file descriptor, taken by the flush thread per batch.
+  std::mutex output_mutex_;
+  int file_descriptor_ = -1;
+
+  std::mutex flush_mutex_;
+  std::condition_variable flush_cv_;
+  std::condition_variable written_cv_;
+  std::atomic<bool> is_flush_thread_sleeping_ = false;
+  uint64_t written_position_ = 0;
+  bool should_terminate_ = false;
+  std::thread flush_thread_;
+
+  Logger();
+  bool try_enqueue(std::string& text);
+  bool try_dequeue(std::string& text);
+  void wake_flush_thread();
+  void run_flush_thread();
+  void write_batch(const std::string& batch);
 
-  Logger() = default;
   Logger(const Logger&) = delete;
   Logger& operator=(const Logger&) = delete;
   Logger(Logger&&) = delete;
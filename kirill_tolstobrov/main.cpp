@@ -138,11 +138,12 @@ int main() {
   const uni_cpp_practice::GraphGenerator generator(params);
 
   auto& logger = prepare_logger();
+  logger.log("Seed: " + std::to_string(params.seed) + "\n");
 
   for (int i = 0; i < graphs_count; i++) {
     logger.log(logger_start_string(i + 1));
 
-    const uni_cpp_practice::Graph graph = generator.generate_random_graph();
+    const uni_cpp_practice::Graph graph = generator.generate_random_graph(i);
 
     logger.log(logger_finish_string(i + 1, graph));
 
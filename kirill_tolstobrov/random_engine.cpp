@@ -0,0 +1,56 @@
+#include "random_engine.hpp"
+
+#include <cstdint>
+
+namespace {
+
+uint64_t splitmix64(uint64_t& state) {
+  uint64_t result = (state += 0x9e3779b97f4a7c15);
+  result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9;
+  result = (result ^ (result >> 27)) * 0x94d049bb133111eb;
+  return result ^ (result >> 31);
+}
+
+uint64_t rotl(uint64_t value, int shift) {
+  return (value << shift) | (value >> (64 - shift));
+}
+
+}  // namespace
+
+namespace uni_cpp_practice {
+
+namespace random_engine {
+
+uint64_t mix_seed(uint64_t seed, uint64_t stream) {
+  uint64_t state = seed ^ splitmix64(stream);
+  return splitmix64(state);
+}
+
+void Engine::reseed(uint64_t seed, uint64_t stream) {
+  uint64_t splitmix_state = mix_seed(seed, stream);
+  for (auto& word : state_)
+    word = splitmix64(splitmix_state);
+}
+
+Engine::result_type Engine::operator()() {
+  const uint64_t result = rotl(state_[1] * 5, 7) * 9;
+  const uint64_t shifted = state_[1] << 17;
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= shifted;
+  state_[3] = rotl(state_[3], 45);
+  return result;
+}
+
+int Engine::get_int(int upper_bound) {
+  // Lemire's multiply-shift reduction, the bias is range / 2^32 which is
+  // negligible for the layer sizes a graph can have.
+  const uint64_t range = static_cast<uint64_t>(upper_bound) + 1;
+  return static_cast<int>((((*this)() >> 32) * range) >> 32);
+}
+
+}  // namespace random_engine
+
+}  // namespace uni_cpp_practice
@@ -8,6 +8,10 @@
 #include <random>
 #include <vector>
 
+#include "bernoulli_mask.hpp"
+
+namespace bernoulli_mask = uni_cpp_practice::bernoulli_mask;
+
 using VertexId = int;
 using EdgeId = int;
 constexpr double GREEN_EDGE_PROBA = 0.1;
@@ -22,6 +26,13 @@ bool get_random_boolean(double proba) {
   return random_boolean(gen);
 }
 
+// ключ потока для bernoulli_mask::fill
+uint64_t get_random_mask_key() {
+  std::random_device rd;
+  const uint64_t high = rd();
+  return (high << 32) | rd();
+}
+
 const VertexId& get_random_vertex_id(const std::vector<VertexId>& vertex_ids) {
   std::random_device rd;
   std::mt19937 gen(rd());
@@ -256,20 +267,26 @@ class GraphGenerator {
     double proba_step = 1.0 / (double)params_.depth;
 
     graph.add_vertex();
+    bernoulli_mask::Mask new_vertices_mask;
     for (int depth = 0; depth < params_.depth; depth++) {
       // создал копию, чтобы не итерироваться по изменяемому массиву
       // т.к. при создании серых граней у новых вершин пересчитывается глубина
       const auto vertex_ids = graph.get_vertex_ids_in_depth(depth);
 
-      for (const auto& vertex_id : vertex_ids) {
-        for (int generate_try_num = 0;
-             generate_try_num < params_.new_vertices_num; generate_try_num++) {
-          if (get_random_boolean(1 - (double)depth * proba_step)) {
+      // все попытки глубины разыгрываются разом, попытка i принадлежит
+      // вершине i / new_vertices_num
+      bernoulli_mask::fill(new_vertices_mask,
+                           vertex_ids.size() * params_.new_vertices_num,
+                           1 - (double)depth * proba_step,
+                           get_random_mask_key());
+      bernoulli_mask::for_each_success(
+          new_vertices_mask,
+          [&graph, &vertex_ids, this](size_t generate_try_num) {
             const auto new_vertex_id = graph.add_vertex();
-            graph.add_edge(vertex_id, new_vertex_id);
-          }
-        }
-      }
+            graph.add_edge(
+                vertex_ids[generate_try_num / params_.new_vertices_num],
+                new_vertex_id);
+          });
     }
   }
 
@@ -290,22 +307,29 @@ class GraphGenerator {
     double proba_step = 1.0 / (double)(graph.get_depth() - 1);
     const auto& depth_map = graph.get_depth_map();
 
+    bernoulli_mask::Mask yellow_mask;
     for (auto vertex_ids_in_depth = depth_map.begin();
          vertex_ids_in_depth != depth_map.end() - 1; vertex_ids_in_depth++) {
-      for (const auto& vertex_id : *vertex_ids_in_depth) {
-        std::vector<VertexId> unconnected_vertex_ids;
-        for (const auto& vertex_id_in_next_depth : *(vertex_ids_in_depth + 1)) {
-          if (!graph.are_connected(vertex_id, vertex_id_in_next_depth)) {
-            unconnected_vertex_ids.push_back(vertex_id_in_next_depth);
-          }
-        }
-        if (unconnected_vertex_ids.size() &&
-            get_random_boolean(proba_step * (double)(vertex_ids_in_depth -
-                                                     depth_map.begin()))) {
-          graph.add_edge(vertex_id,
-                         get_random_vertex_id(unconnected_vertex_ids));
-        }
-      }
+      bernoulli_mask::fill(
+          yellow_mask, vertex_ids_in_depth->size(),
+          proba_step * (double)(vertex_ids_in_depth - depth_map.begin()),
+          get_random_mask_key());
+      // несвязанные вершины ищутся только для выпавших вершин
+      bernoulli_mask::for_each_success(
+          yellow_mask, [&graph, vertex_ids_in_depth](size_t index) {
+            const auto& vertex_id = (*vertex_ids_in_depth)[index];
+            std::vector<VertexId> unconnected_vertex_ids;
+            for (const auto& vertex_id_in_next_depth :
+                 *(vertex_ids_in_depth + 1)) {
+              if (!graph.are_connected(vertex_id, vertex_id_in_next_depth)) {
+                unconnected_vertex_ids.push_back(vertex_id_in_next_depth);
+              }
+            }
+            if (unconnected_vertex_ids.size()) {
+              graph.add_edge(vertex_id,
+                             get_random_vertex_id(unconnected_vertex_ids));
+            }
+          });
     }
   };
 
@@ -0,0 +1,208 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "graph.hpp"
+#include "graph_generator.hpp"
+#include "graph_printer.hpp"
+#include "logger.hpp"
+#include "random_engine.hpp"
+
+namespace {
+
+using uni_cpp_practice::Depth;
+using uni_cpp_practice::Edge;
+using uni_cpp_practice::Graph;
+using uni_cpp_practice::GraphGenerator;
+using uni_cpp_practice::GraphPrinter;
+using uni_cpp_practice::Logger;
+using uni_cpp_practice::VertexId;
+
+// Зафиксирован, чтобы каждый запуск мерил одни и те же графы
+constexpr uint64_t SEED = 1;
+// Желтый проход сравнивает вершину со всем следующим уровнем, графы
+// больше этого слишком долго строить снова и снова
+constexpr double MAX_EXPECTED_VERTICES_NUM = 1 << 10;
+constexpr int CHECK_BINDING_QUERIES_NUM = 1 << 12;
+const std::string NULL_DEVICE = "/dev/null";
+
+// У вершины на глубине d в среднем new_vertices_num * (1 - d / depth)
+// детей, как их разыгрывает generate_gray_branch
+double get_expected_vertices_num(Depth depth, int new_vertices_num) {
+  double layer_size = 1;
+  double vertices_num = 1;
+  for (Depth current_depth = 0; current_depth < depth; ++current_depth) {
+    layer_size *=
+        new_vertices_num * (1.0 - static_cast<double>(current_depth) / depth);
+    vertices_num += layer_size;
+  }
+  return vertices_num;
+}
+
+// Глубины 2..14 на new_vertices_num 1..10, кроме слишком больших. Генератор
+// работает на пуле, поэтому скорости считаются по настенным часам
+void add_graph_sizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"depth", "new_vertices"})->UseRealTime();
+  for (Depth depth = 2; depth <= 14; depth += 3) {
+    for (const int new_vertices_num : {1, 2, 4, 7, 10}) {
+      if (get_expected_vertices_num(depth, new_vertices_num) <=
+          MAX_EXPECTED_VERTICES_NUM) {
+        benchmark->Args({depth, new_vertices_num});
+      }
+    }
+  }
+}
+
+GraphGenerator::Params get_params(const benchmark::State& state) {
+  return GraphGenerator::Params(state.range(0), state.range(1), SEED);
+}
+
+int64_t get_vertices_num(const Graph& graph) {
+  return graph.get_vertex_map().size();
+}
+
+int64_t get_edges_num(const Graph& graph) {
+  return graph.get_edge_map().size();
+}
+
+void set_graph_counters(benchmark::State& state,
+                        int64_t vertices_num,
+                        int64_t edges_num) {
+  state.counters["vertices/s"] =
+      benchmark::Counter(vertices_num, benchmark::Counter::kIsRate);
+  state.counters["edges/s"] =
+      benchmark::Counter(edges_num, benchmark::Counter::kIsRate);
+}
+
+void BM_Generate(benchmark::State& state) {
+  const GraphGenerator generator(get_params(state));
+  int graph_num = 0;
+  int64_t vertices_num = 0;
+  int64_t edges_num = 0;
+  for (auto _ : state) {
+    const Graph graph = generator.generate(graph_num++);
+    vertices_num += get_vertices_num(graph);
+    edges_num += get_edges_num(graph);
+  }
+  set_graph_counters(state, vertices_num, edges_num);
+}
+BENCHMARK(BM_Generate)->Apply(add_graph_sizes);
+
+void BM_GenerateGrayTree(benchmark::State& state) {
+  const GraphGenerator generator(get_params(state));
+  int graph_num = 0;
+  int64_t vertices_num = 0;
+  int64_t edges_num = 0;
+  for (auto _ : state) {
+    const Graph graph = generator.generate_gray_tree(graph_num++);
+    vertices_num += get_vertices_num(graph);
+    edges_num += get_edges_num(graph);
+  }
+  set_graph_counters(state, vertices_num, edges_num);
+}
+BENCHMARK(BM_GenerateGrayTree)->Apply(add_graph_sizes);
+
+// Один цветной проход по свежему серому дереву, замеряется только он.
+// Считаются ребра, которые он добавил
+template <Edge::Color color>
+void BM_PaintEdges(benchmark::State& state) {
+  const GraphGenerator generator(get_params(state));
+  std::optional<Graph> graph;
+  int graph_num = 0;
+  int64_t vertices_num = 0;
+  int64_t edges_num = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    graph.reset();
+    graph.emplace(generator.generate_gray_tree(graph_num));
+    const int64_t gray_edges_num = get_edges_num(*graph);
+    state.ResumeTiming();
+
+    generator.paint_edges(*graph, graph_num++, color);
+    vertices_num += get_vertices_num(*graph);
+    edges_num += get_edges_num(*graph) - gray_edges_num;
+  }
+  set_graph_counters(state, vertices_num, edges_num);
+}
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Green)->Apply(add_graph_sizes);
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Blue)->Apply(add_graph_sizes);
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Yellow)->Apply(add_graph_sizes);
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Red)->Apply(add_graph_sizes);
+
+// Половина запрашиваемых пар - ребра, половина - случайные вершины
+void BM_IsConnected(benchmark::State& state) {
+  const Graph graph = GraphGenerator(get_params(state)).generate();
+  uni_cpp_practice::random_engine::Engine engine(SEED);
+  const int64_t vertices_num = get_vertices_num(graph);
+  const int64_t edges_num = get_edges_num(graph);
+  std::vector<std::pair<VertexId, VertexId>> pairs;
+  pairs.reserve(CHECK_BINDING_QUERIES_NUM);
+  for (int i = 0; i < CHECK_BINDING_QUERIES_NUM; ++i) {
+    if (i % 2 == 0) {
+      const Edge& edge = graph.get_edge(engine() % edges_num);
+      pairs.push_back(edge.get_binded_vertices());
+    } else {
+      pairs.emplace_back(engine() % vertices_num, engine() % vertices_num);
+    }
+  }
+
+  for (auto _ : state) {
+    for (const auto& [from_vertex_id, to_vertex_id] : pairs) {
+      benchmark::DoNotOptimize(
+          graph.check_binding(from_vertex_id, to_vertex_id));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * pairs.size());
+}
+BENCHMARK(BM_IsConnected)->Apply(add_graph_sizes);
+
+void BM_PrintGraph(benchmark::State& state) {
+  const Graph graph = GraphGenerator(get_params(state)).generate();
+  const GraphPrinter printer(graph);
+  int64_t bytes_num = 0;
+  for (auto _ : state) {
+    const std::string json = printer.print();
+    benchmark::DoNotOptimize(json.data());
+    bytes_num += json.size();
+  }
+  state.SetBytesProcessed(bytes_num);
+  set_graph_counters(state, state.iterations() * get_vertices_num(graph),
+                     state.iterations() * get_edges_num(graph));
+}
+BENCHMARK(BM_PrintGraph)->Apply(add_graph_sizes);
+
+// Вызываются раз до старта потоков запуска и раз после их завершения,
+// так что смена вывода не гоняется с замеряемыми записями
+void set_up_logger(const benchmark::State&) {
+  auto& logger = Logger::get_instance();
+  logger.set_stdout_enabled(false);
+  logger.set_file(NULL_DEVICE);
+}
+
+void tear_down_logger(const benchmark::State&) {
+  Logger::get_instance().flush();
+}
+
+// Устойчивая скорость: когда кольцо заполнено, log ждет поток сброса
+void BM_LoggerLog(benchmark::State& state) {
+  auto& logger = Logger::get_instance();
+  const std::string record = "2026.01.01 12:00:00: Graph " +
+                             std::to_string(state.thread_index()) +
+                             ", Generation Started\n";
+  for (auto _ : state) {
+    logger.log(record);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerLog)
+    ->Setup(set_up_logger)
+    ->Teardown(tear_down_logger)
+    ->Threads(1)
+    ->Threads(4);
+
+}  // namespace
+
+BENCHMARK_MAIN();
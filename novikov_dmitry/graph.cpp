@@ -111,6 +111,7 @@ void Graph::add_edge(const VertexId& from_vertex_id,
   const auto new_edge =
       edge_map_.insert({new_edge_id, Edge(from_vertex_id, to_vertex_id,
                                           new_edge_id, new_edge_color)});
+  colored_edge_ids_[static_cast<int>(new_edge_color)].push_back(new_edge_id);
   get_mutable_vertex(from_vertex_id).add_edge_id(new_edge.first->first);
   if (from_vertex_id != to_vertex_id) {
     get_mutable_vertex(to_vertex_id).add_edge_id(new_edge.first->first);
@@ -144,16 +145,6 @@ bool Graph::check_binding(const VertexId& from_vertex_id,
   return false;
 }
 
-int Graph::count_edges_of_color(const Edge::Color& color) const {
-  int count = 0;
-  for (const auto& [edge_id, edge] : get_edge_map()) {
-    if (edge.color == color) {
-      ++count;
-    }
-  }
-  return count;
-}
-
 Depth Graph::get_depth() const {
   return (depth_map_.size() > DEFAULT_DEPTH) ? (depth_map_.size() - 1)
                                              : DEFAULT_DEPTH;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -33,6 +34,7 @@ class Vertex {
 class Edge {
  public:
   enum class Color { Gray, Green, Blue, Yellow, Red };
+  static constexpr int COLORS_COUNT = 5;
 
   const Color color;
 
@@ -85,7 +87,15 @@ class Graph {
     return edge_map_;
   }
 
-  int count_edges_of_color(const Edge::Color& color) const;
+  // Счетчики ведутся в add_edge, подсчет не проходит по всем ребрам
+  int count_edges_of_color(const Edge::Color& color) const {
+    return get_edge_ids_of_color(color).size();
+  }
+
+  const std::vector<EdgeId>& get_edge_ids_of_color(
+      const Edge::Color& color) const {
+    return colored_edge_ids_[static_cast<int>(color)];
+  }
 
   Depth get_depth() const;
 
@@ -100,6 +110,7 @@ class Graph {
   EdgeId default_edge_id_ = 0;
   std::unordered_map<VertexId, Vertex> vertex_map_;
   std::unordered_map<EdgeId, Edge> edge_map_;
+  std::array<std::vector<EdgeId>, Edge::COLORS_COUNT> colored_edge_ids_;
   std::vector<std::vector<VertexId>> depth_map_ = {{}};
 
   VertexId get_default_vertex_id() { return default_vertex_id_++; }
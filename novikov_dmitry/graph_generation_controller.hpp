@@ -1,39 +1,16 @@
 #pragma once
 
-#include <atomic>
 #include <functional>
-#include <list>
 #include <mutex>
-#include <thread>
 #include "graph_generator.hpp"
 
 namespace uni_cpp_practice {
 
 class GraphGenerationController {
  public:
-  using JobCallback = std::function<void()>;
-  using GetJobCallback = std::function<std::optional<JobCallback>()>;
   using GenStartedCallback = std::function<void(int)>;
   using GenFinishedCallback = std::function<void(int, Graph)>;
 
-  class Worker {
-   public:
-    explicit Worker(const GetJobCallback& get_job_callback)
-        : get_job_callback_(get_job_callback){};
-
-    enum class State { Idle, Working, ShouldTerminate };
-
-    void start();
-    void stop();
-
-    ~Worker();
-
-   private:
-    std::thread thread_;
-    GetJobCallback get_job_callback_;
-    std::atomic<State> state_ = State::Idle;
-  };
-
   GraphGenerationController(
       int threads_count,
       int graphs_count,
@@ -43,11 +20,9 @@ class GraphGenerationController {
                 const GenFinishedCallback& gen_finished_callback);
 
  private:
-  std::list<Worker> workers_;
-  std::list<JobCallback> jobs_;
+  const int threads_count_;
   const int graphs_count_;
   const GraphGenerator graph_generator_;
-  std::mutex mutex_jobs_;
   std::mutex mutex_start_callback_;
   std::mutex mutex_finish_callback_;
 };
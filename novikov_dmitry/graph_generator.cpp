@@ -1,16 +1,15 @@
 #include "graph_generator.hpp"
-#include <array>
-#include <atomic>
 #include <cassert>
-#include <functional>
 #include <limits>
-#include <list>
 #include <random>
-#include <thread>
+#include <utility>
+#include <vector>
+#include "random_engine.hpp"
+#include "thread_pool.hpp"
 
 namespace {
 
-constexpr int MAX_THREADS_COUNT = 4;
+constexpr int BRANCH_ROOT_INDEX = -1;
 
 using uni_cpp_practice::Depth;
 using uni_cpp_practice::Edge;
@@ -18,6 +17,7 @@ using uni_cpp_practice::Graph;
 using uni_cpp_practice::Vertex;
 using uni_cpp_practice::VertexId;
 using Params = uni_cpp_practice::GraphGenerator::Params;
+using Engine = uni_cpp_practice::random_engine::Engine;
 
 float get_color_probability(const Edge::Color& color) {
   switch (color) {
@@ -34,120 +34,130 @@ float get_color_probability(const Edge::Color& color) {
   }
 }
 
-bool is_lucky(float probability) {
+bool is_lucky(float probability, Engine& engine) {
   assert(probability + std::numeric_limits<float>::epsilon() >= 0 &&
          probability - std::numeric_limits<float>::epsilon() <= 1.0 &&
          "given probability is incorrect");
-  static std::knuth_b rand_engine{};
-  std::mt19937 rng{rand_engine()};
   std::bernoulli_distribution bernoullu_distribution_var(probability);
-  return bernoullu_distribution_var(rng);
+  return bernoullu_distribution_var(engine);
 }
 
-int get_random_number(int size) {
-  std::random_device
-      rd;  // Will be used to obtain a seed for the random number engine
-  std::default_random_engine gen(rd());
+// Вызывает on_success для индексов из [first, last), где испытание
+// с вероятностью probability удачно. Вместо броска на каждую вершину
+// разыгрывается длина промежутка до следующей удачи (геометрическое
+// распределение): распределение то же, а бросков столько же, сколько ребер
+template <typename OnSuccess>
+void for_each_lucky(int first,
+                    int last,
+                    float probability,
+                    Engine& engine,
+                    const OnSuccess& on_success) {
+  if (probability <= 0) {
+    return;
+  }
+  std::geometric_distribution<int> gap_distribution(probability);
+  for (int idx = first + gap_distribution(engine); idx < last;
+       idx += 1 + gap_distribution(engine)) {
+    on_success(idx);
+  }
+}
+
+int get_random_number(int size, Engine& engine) {
   std::uniform_int_distribution<int> distrib(0, size - 1);
-  return distrib(gen);
+  return distrib(engine);
 }
 
-void generate_green_edges(Graph& graph, std::mutex& mutex_add_edge) {
+// Ребра, найденные одной задачей, до слияния с графом
+struct EdgeCandidates {
+  Edge::Color color = Edge::Color::Gray;
+  std::vector<std::pair<VertexId, VertexId>> edges;
+};
+
+void generate_green_edges(const Graph& graph,
+                          const Depth current_depth,
+                          Engine& engine,
+                          EdgeCandidates& candidates) {
   const float probability = get_color_probability(Edge::Color::Green);
-  for (const auto& [current_vertex_id, current_vertex] :
-       graph.get_vertex_map()) {
-    if (is_lucky(probability)) {
-      const std::lock_guard lock(mutex_add_edge);
-      graph.add_edge(current_vertex_id, current_vertex_id, Edge::Color::Green);
-    }
-  }
+  const auto& vertices_at_depth = graph.get_vertices_at_depth(current_depth);
+  for_each_lucky(0, vertices_at_depth.size(), probability, engine,
+                 [&vertices_at_depth, &candidates](int idx) {
+                   candidates.edges.emplace_back(vertices_at_depth[idx],
+                                                 vertices_at_depth[idx]);
+                 });
 }
 
-void generate_blue_edges(Graph& graph, std::mutex& mutex_add_edge) {
+void generate_blue_edges(const Graph& graph,
+                         const Depth current_depth,
+                         Engine& engine,
+                         EdgeCandidates& candidates) {
   const float probability = get_color_probability(Edge::Color::Blue);
-  // так как на нулевом уровне только одна вершина == нулевая, нет смысла ее
-  // учитывать
-  for (Depth current_depth = 1; current_depth <= graph.get_depth();
-       ++current_depth) {
-    const auto& vertices_at_depth = graph.get_vertices_at_depth(current_depth);
-    for (int idx = 0; idx < vertices_at_depth.size() - 1; ++idx) {
-      if (is_lucky(probability)) {
-        const std::lock_guard lock(mutex_add_edge);
-        graph.add_edge(vertices_at_depth[idx], vertices_at_depth[idx + 1],
-                       Edge::Color::Blue);
-      }
-    }
-  }
+  const auto& vertices_at_depth = graph.get_vertices_at_depth(current_depth);
+  for_each_lucky(0, int(vertices_at_depth.size()) - 1, probability, engine,
+                 [&vertices_at_depth, &candidates](int idx) {
+                   candidates.edges.emplace_back(vertices_at_depth[idx],
+                                                 vertices_at_depth[idx + 1]);
+                 });
 }
 
-void generate_yellow_edges(Graph& graph, std::mutex& mutex_add_edge) {
-  float probability =
-      get_color_probability(Edge::Color::Yellow) / (graph.get_depth() - 1);
-  float yellow_edge_probability = probability;
-  //так как вероятность генерации желтых ребер из нулевой вершины должна быть
-  //нулевой, то можно просто не рассматривать эту вершину
-  for (Depth current_depth = 1; current_depth < graph.get_depth();
-       ++current_depth) {
-    const auto& vertices_at_depth = graph.get_vertices_at_depth(current_depth);
-    const auto& vertices_at_next_depth =
-        graph.get_vertices_at_depth(current_depth + 1);
-    for (const auto& current_vertex_id : vertices_at_depth) {
-      if (is_lucky(yellow_edge_probability)) {
-        std::vector<VertexId> not_binded_vertices;
-        for (const auto& next_vertex_id : vertices_at_next_depth) {
-          const auto is_binded = [&graph, &mutex_add_edge, &current_vertex_id,
-                                  &next_vertex_id]() {
-            const std::lock_guard lock(mutex_add_edge);
-            return graph.check_binding(current_vertex_id, next_vertex_id);
-          }();
-          if (!is_binded) {
-            not_binded_vertices.push_back(next_vertex_id);
-          }
-        }
-        if (not_binded_vertices.size()) {
-          const int idx = get_random_number(not_binded_vertices.size());
-          const std::lock_guard lock(mutex_add_edge);
-          graph.add_edge(current_vertex_id, not_binded_vertices[idx],
-                         Edge::Color::Yellow);
+// До слияния в графе есть только серые ребра, поэтому граф можно читать
+// из нескольких задач без блокировок
+void generate_yellow_edges(const Graph& graph,
+                           const Depth current_depth,
+                           Engine& engine,
+                           EdgeCandidates& candidates) {
+  const float yellow_edge_probability =
+      get_color_probability(Edge::Color::Yellow) * current_depth /
+      (graph.get_depth() - 1);
+  const auto& vertices_at_next_depth =
+      graph.get_vertices_at_depth(current_depth + 1);
+  for (const auto& current_vertex_id :
+       graph.get_vertices_at_depth(current_depth)) {
+    if (is_lucky(yellow_edge_probability, engine)) {
+      std::vector<VertexId> not_binded_vertices;
+      for (const auto& next_vertex_id : vertices_at_next_depth) {
+        if (!graph.check_binding(current_vertex_id, next_vertex_id)) {
+          not_binded_vertices.push_back(next_vertex_id);
         }
       }
+      if (not_binded_vertices.size()) {
+        const int idx =
+            get_random_number(not_binded_vertices.size(), engine);
+        candidates.edges.emplace_back(current_vertex_id,
+                                      not_binded_vertices[idx]);
+      }
     }
-    yellow_edge_probability += probability;
   }
 }
 
-void generate_red_edges(Graph& graph, std::mutex& mutex_add_edge) {
+void generate_red_edges(const Graph& graph,
+                        const Depth current_depth,
+                        Engine& engine,
+                        EdgeCandidates& candidates) {
   const float probability = get_color_probability(Edge::Color::Red);
-  for (Depth current_depth = 0; current_depth < graph.get_depth() - 1;
-       ++current_depth) {
-    const auto& vertices_at_depth = graph.get_vertices_at_depth(current_depth);
-    const auto& vertices_at_next_depth =
-        graph.get_vertices_at_depth(current_depth + 2);
-    for (const auto& current_vertex_id : vertices_at_depth) {
-      if (is_lucky(probability)) {
-        const int index = get_random_number(vertices_at_next_depth.size());
-        const std::lock_guard lock(mutex_add_edge);
-        graph.add_edge(current_vertex_id, vertices_at_next_depth[index],
-                       Edge::Color::Red);
-      }
-    }
-  }
+  const auto& vertices_at_depth = graph.get_vertices_at_depth(current_depth);
+  const auto& vertices_at_next_depth =
+      graph.get_vertices_at_depth(current_depth + 2);
+  for_each_lucky(
+      0, vertices_at_depth.size(), probability, engine,
+      [&vertices_at_depth, &vertices_at_next_depth, &engine,
+       &candidates](int idx) {
+        const int index =
+            get_random_number(vertices_at_next_depth.size(), engine);
+        candidates.edges.emplace_back(vertices_at_depth[idx],
+                                      vertices_at_next_depth[index]);
+      });
 }
 }  // namespace
 
 namespace uni_cpp_practice {
 
-void GraphGenerator::generate_gray_branch(Graph& graph,
-                                          std::mutex& mutex_add,
-                                          const VertexId& parent_vertex_id,
-                                          const Depth current_depth) const {
+void GraphGenerator::generate_gray_branch(std::vector<int>& parent_indices,
+                                          const int parent_index,
+                                          const Depth current_depth,
+                                          Engine& engine) const {
   assert(current_depth <= params_.depth && "Depth error");
-  const auto new_vertex_id = [&graph, &mutex_add, &parent_vertex_id]() {
-    const std::lock_guard lock(mutex_add);
-    const auto& new_vertex_id = graph.add_vertex();
-    graph.add_edge(parent_vertex_id, new_vertex_id);
-    return new_vertex_id;
-  }();
+  const int new_vertex_index = parent_indices.size();
+  parent_indices.push_back(parent_index);
   if (current_depth == params_.depth) {
     return;
   }
@@ -155,104 +165,113 @@ void GraphGenerator::generate_gray_branch(Graph& graph,
   const float new_vertex_probability =
       probability * (1 - (float(current_depth) / float(params_.depth)));
   for (int i = 0; i < params_.new_vertices_num; ++i) {
-    if (is_lucky(new_vertex_probability)) {
-      generate_gray_branch(graph, mutex_add, new_vertex_id, current_depth + 1);
+    if (is_lucky(new_vertex_probability, engine)) {
+      generate_gray_branch(parent_indices, new_vertex_index,
+                           current_depth + 1, engine);
     }
   }
 }
 
 void GraphGenerator::generate_gray_edges(
     Graph& graph,
-    const VertexId& parent_vertex_id) const {
-  // Job - это lambda функция,
-  // которая энкапсулирует в себе генерацию однйо ветви
-  using JobCallback = std::function<void()>;
-  auto jobs = std::list<JobCallback>();
-
-  // Заполняем список работ для воркеров
-  std::atomic<int> jobs_counter = 0;
-  std::mutex mutex_add;
-  Depth current_depth = 0;
-  for (int i = 0; i < params_.new_vertices_num; i++) {
-    jobs.emplace_back([this, &graph, &mutex_add, &jobs_counter,
-                       &parent_vertex_id, current_depth]() {
-      generate_gray_branch(graph, mutex_add, parent_vertex_id,
-                           current_depth + 1);
-      ++jobs_counter;
+    const VertexId& parent_vertex_id,
+    uint64_t graph_seed) const {
+  // Каждая ветвь строится в своем буфере, потоки не трогают граф и
+  // не ждут друг друга на мьютексе
+  const int branches_count = params_.new_vertices_num;
+  std::vector<std::vector<int>> branches(branches_count);
+  TaskGroup branch_jobs;
+  for (int i = 0; i < branches_count; ++i) {
+    branch_jobs.run([this, &branch = branches[i], graph_seed, i]() {
+      Engine engine(graph_seed, i);
+      generate_gray_branch(branch, BRANCH_ROOT_INDEX, 1, engine);
     });
   }
+  branch_jobs.wait();
 
-  // Создаем воркера,
-  // который в бесконечном цикле проверяет,
-  // есть ли работа, и выполняет её
-  std::mutex mutex_jobs;
-  std::atomic<bool> should_terminate = false;
-  const auto worker = [&should_terminate, &mutex_jobs, &jobs]() {
-    while (true) {
-      // Проверка флага, должны ли мы остановить поток
-      if (should_terminate) {
-        return;
-      }
-      // Проверяем, есть ли для нас работа
-      const auto job_optional = [&mutex_jobs,
-                                 &jobs]() -> std::optional<JobCallback> {
-        const std::lock_guard lock(mutex_jobs);
-        if (jobs.empty()) {
-          return std::nullopt;
-        }
-        const auto first_job = jobs.front();
-        jobs.pop_front();
-        return first_job;
-      }();
-      if (job_optional.has_value()) {
-        // Работа есть, выполняем её
-        const auto& job = job_optional.value();
-        job();
-      }
+  // Вливаем ветви в граф по порядку, переводя локальные индексы в id
+  for (const auto& parent_indices : branches) {
+    std::vector<VertexId> branch_vertex_ids;
+    branch_vertex_ids.reserve(parent_indices.size());
+    for (const int parent_index : parent_indices) {
+      const VertexId new_vertex_id = graph.add_vertex();
+      graph.add_edge(parent_index == BRANCH_ROOT_INDEX
+                         ? parent_vertex_id
+                         : branch_vertex_ids[parent_index],
+                     new_vertex_id);
+      branch_vertex_ids.push_back(new_vertex_id);
     }
-  };
-
-  // Создаем и запускаем потоки с воркерами
-  // MAX_THREADS_COUNT = 4
-  std::array<std::thread, MAX_THREADS_COUNT> threads;
-  for (int i = 0; i < MAX_THREADS_COUNT; ++i) {
-    threads[i] = std::thread(worker);
-  }
-
-  // Ждем, когда все ветви будут сгенерированы
-  while (jobs_counter < params_.new_vertices_num) {
   }
+}
 
-  // Останавливем всех воркеров и потоки
-  should_terminate = true;
-  for (auto& thread : threads) {
-    thread.join();
-  }
+Graph GraphGenerator::generate(int graph_num) const {
+  auto graph = generate_gray_tree(graph_num);
+  paint_edges(graph, graph_num);
+  return graph;
 }
 
-Graph GraphGenerator::generate() const {
+Graph GraphGenerator::generate_gray_tree(int graph_num) const {
   auto graph = Graph();
   const VertexId& new_vertex_id = graph.add_vertex();
-  std::mutex mutex_add_edge;
-  if (params_.depth == 0 || params_.new_vertices_num == 0) {
-    std::thread green_thread(generate_green_edges, std::ref(graph),
-                             std::ref(mutex_add_edge));
-    green_thread.join();
-    return graph;
+  if (params_.depth > 0 && params_.new_vertices_num > 0) {
+    generate_gray_edges(graph, new_vertex_id, get_graph_seed(graph_num));
   }
-  generate_gray_edges(graph, new_vertex_id);
-  std::thread green_thread(generate_green_edges, std::ref(graph),
-                           std::ref(mutex_add_edge));
-  std::thread yellow_thread(generate_yellow_edges, std::ref(graph),
-                            std::ref(mutex_add_edge));
-  std::thread red_thread(generate_red_edges, std::ref(graph),
-                         std::ref(mutex_add_edge));
-  std::thread blue_thread(generate_blue_edges, std::ref(graph),
-                          std::ref(mutex_add_edge));
-  green_thread.join();
-  yellow_thread.join();
-  red_thread.join();
-  blue_thread.join();
   return graph;
 }
+
+void GraphGenerator::paint_edges(
+    Graph& graph,
+    int graph_num,
+    const std::optional<Edge::Color>& only_color) const {
+  // Каждый цвет делится по уровням глубины: одна задача пула на уровень,
+  // ребра копятся в ее буфере, а в граф вливаются одним проходом.
+  // Задачи берут потоки после потоков ветвей, в порядке постановки,
+  // пропущенные цвета тоже занимают свои потоки
+  const uint64_t graph_seed = get_graph_seed(graph_num);
+  const Depth graph_depth = graph.get_depth();
+  uint64_t next_stream = params_.new_vertices_num;
+  std::vector<EdgeCandidates> candidates;
+  // Буферы не должны переезжать, пока задачи в них пишут
+  candidates.reserve(4 * (graph_depth + 1));
+  TaskGroup color_jobs;
+  const auto run_color_jobs = [&graph, &candidates, &color_jobs, &only_color,
+                               &next_stream, graph_seed](
+                                  const Edge::Color color,
+                                  const Depth first_depth,
+                                  const Depth last_depth,
+                                  auto generate_edges) {
+    for (Depth current_depth = first_depth; current_depth <= last_depth;
+         ++current_depth) {
+      const uint64_t stream = next_stream++;
+      if (only_color.has_value() && only_color.value() != color) {
+        continue;
+      }
+      auto& layer_candidates = candidates.emplace_back();
+      layer_candidates.color = color;
+      color_jobs.run([&graph, &layer_candidates, current_depth,
+                      generate_edges, graph_seed, stream]() {
+        Engine engine(graph_seed, stream);
+        generate_edges(graph, current_depth, engine, layer_candidates);
+      });
+    }
+  };
+  run_color_jobs(Edge::Color::Green, 0, graph_depth, generate_green_edges);
+  // так как на нулевом уровне только одна вершина == нулевая, нет смысла ее
+  // учитывать
+  run_color_jobs(Edge::Color::Blue, 1, graph_depth, generate_blue_edges);
+  //так как вероятность генерации желтых ребер из нулевой вершины должна быть
+  //нулевой, то можно просто не рассматривать эту вершину
+  run_color_jobs(Edge::Color::Yellow, 1, graph_depth - 1,
+                 generate_yellow_edges);
+  run_color_jobs(Edge::Color::Red, 0, graph_depth - 2, generate_red_edges);
+  color_jobs.wait();
+
+  for (const auto& layer_candidates : candidates) {
+    for (const auto& [from_vertex_id, to_vertex_id] : layer_candidates.edges) {
+      if (!graph.check_binding(from_vertex_id, to_vertex_id)) {
+        graph.add_edge(from_vertex_id, to_vertex_id, layer_candidates.color);
+      }
+    }
+  }
+}
 }  // namespace uni_cpp_practice
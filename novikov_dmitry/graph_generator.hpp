@@ -1,31 +1,57 @@
 #pragma once
 
-#include <mutex>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
 #include "graph.hpp"
+#include "random_engine.hpp"
 
 namespace uni_cpp_practice {
 
 class GraphGenerator {
  public:
   struct Params {
-    explicit Params(Depth _depth = 0, int _new_vertices_num = 0)
-        : depth(_depth), new_vertices_num(_new_vertices_num) {}
+    explicit Params(Depth _depth = 0,
+                    int _new_vertices_num = 0,
+                    uint64_t _seed = std::random_device{}())
+        : depth(_depth), new_vertices_num(_new_vertices_num), seed(_seed) {}
 
     const Depth depth = 0;
     const int new_vertices_num = 0;
+    // Графы с одинаковыми params и graph_num совпадают, на каких бы
+    // потоках ни выполнялись их задачи
+    const uint64_t seed = 0;
   };
 
   explicit GraphGenerator(const Params& params = Params()) : params_(params) {}
 
-  Graph generate() const;
+  Graph generate(int graph_num = 0) const;
+
+  // Два этапа generate по отдельности, чтобы их можно было замерить: серое
+  // дерево, затем цветные ребра поверх него. Если задан only_color,
+  // рисуется только этот цвет, ребра те же, что дал бы generate
+  Graph generate_gray_tree(int graph_num = 0) const;
+  void paint_edges(
+      Graph& graph,
+      int graph_num = 0,
+      const std::optional<Edge::Color>& only_color = std::nullopt) const;
 
  private:
   const Params params_ = Params();
+  uint64_t get_graph_seed(int graph_num) const {
+    return random_engine::mix_seed(params_.seed, graph_num);
+  }
+  // Ветвь i берет случайные числа из потока i от graph_seed
   void generate_gray_edges(Graph& graph,
-                           const VertexId& parent_vertex_id) const;
-  void generate_gray_branch(Graph& graph,
-                            std::mutex& mutex_add,
-                            const VertexId& parent_vertex_id,
-                            const Depth current_depth) const;
+                           const VertexId& parent_vertex_id,
+                           uint64_t graph_seed) const;
+  // Ветвь строится в локальном буфере без блокировок:
+  // parent_indices[i] - индекс родителя i-й вершины внутри ветви
+  // (-1 для корня ветви)
+  void generate_gray_branch(std::vector<int>& parent_indices,
+                            const int parent_index,
+                            const Depth current_depth,
+                            random_engine::Engine& engine) const;
 };
 }  // namespace uni_cpp_practice
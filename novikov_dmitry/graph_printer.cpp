@@ -1,71 +1,74 @@
 #include "graph_printer.hpp"
+#include <ostream>
+#include <sstream>
 
 namespace {
 
-std::string print_vertex(const uni_cpp_practice::Vertex& vertex) {
-  std::stringstream ss_out;
-  std::string tab_1 = "    ";
-  std::string tab_2 = tab_1 + tab_1;
-  ss_out << tab_2 << "{\n";
-  ss_out << tab_2 << tab_1 << "\"id\": " << vertex.id << ",\n";
-  ss_out << tab_2 << tab_1 << "\"edge_ids\": [";
+constexpr const char* TAB_1 = "    ";
+constexpr const char* TAB_2 = "        ";
+constexpr const char* TAB_3 = "            ";
+
+// Элементы пишутся прямо в поток, без промежуточных строк на каждую
+// вершину и ребро
+void print_vertex(const uni_cpp_practice::Vertex& vertex, std::ostream& out) {
+  out << TAB_2 << "{\n";
+  out << TAB_3 << "\"id\": " << vertex.id << ",\n";
+  out << TAB_3 << "\"edge_ids\": [";
   const auto& edge_ids = vertex.get_edge_ids();
   for (auto it = edge_ids.begin(); it != edge_ids.end(); ++it) {
     if (it != edge_ids.begin()) {
-      ss_out << ", ";
+      out << ", ";
     }
-    ss_out << *it;
+    out << *it;
   }
-  ss_out << "],\n";
-  ss_out << tab_2 << tab_1 << "\"depth\": " << vertex.depth << "\n";
-  ss_out << tab_2 << "}";
-  return ss_out.str();
+  out << "],\n";
+  out << TAB_3 << "\"depth\": " << vertex.depth << "\n";
+  out << TAB_2 << "}";
 }
 
-std::string print_edge(const uni_cpp_practice::Edge& edge) {
-  std::stringstream ss_out;
-  std::string tab_1 = "    ";
-  std::string tab_2 = tab_1 + tab_1;
-  ss_out << tab_2 << "{\n";
-  ss_out << tab_2 << tab_1 << "\"id\": " << edge.get_id() << ",\n";
-  ss_out << tab_2 << tab_1 << "\"vertex_ids\": [";
-  ss_out << edge.get_binded_vertices().first << ", "
-         << edge.get_binded_vertices().second;
-  ss_out << "],\n";
-  ss_out << tab_2 << tab_1 << "\"color\": "
-         << "\"" << color_to_string(edge.color) << "\""
-         << "\n";
-  ss_out << tab_2 << "}";
-  return ss_out.str();
+void print_edge(const uni_cpp_practice::Edge& edge, std::ostream& out) {
+  out << TAB_2 << "{\n";
+  out << TAB_3 << "\"id\": " << edge.get_id() << ",\n";
+  out << TAB_3 << "\"vertex_ids\": [";
+  out << edge.get_binded_vertices().first << ", "
+      << edge.get_binded_vertices().second;
+  out << "],\n";
+  out << TAB_3 << "\"color\": "
+      << "\"" << color_to_string(edge.color) << "\""
+      << "\n";
+  out << TAB_2 << "}";
 }
 }  // namespace
 
 namespace uni_cpp_practice {
-std::string GraphPrinter::print() const {
-  std::stringstream ss_out;
-  std::string tab_1 = "    ";
-  ss_out << "{\n";
-  ss_out << tab_1 << "\"depth\": " << graph_.get_depth() << ",\n";
-  ss_out << tab_1 << "\"vertices\": [\n";
+void GraphPrinter::print(std::ostream& out) const {
+  out << "{\n";
+  out << TAB_1 << "\"depth\": " << graph_.get_depth() << ",\n";
+  out << TAB_1 << "\"vertices\": [\n";
   const auto& vertex_map = graph_.get_vertex_map();
   for (auto it = vertex_map.begin(); it != vertex_map.end(); ++it) {
     if (it != vertex_map.begin()) {
-      ss_out << ", ";
+      out << ", ";
     }
-    ss_out << print_vertex(it->second);
+    print_vertex(it->second, out);
   }
-  ss_out << std::endl << tab_1 << "],\n";
+  out << "\n" << TAB_1 << "],\n";
 
-  ss_out << tab_1 << "\"edges\": [\n";
+  out << TAB_1 << "\"edges\": [\n";
   const auto& edge_map = graph_.get_edge_map();
   for (auto it = edge_map.begin(); it != edge_map.end(); ++it) {
     if (it != edge_map.begin()) {
-      ss_out << ", ";
+      out << ", ";
     }
-    ss_out << print_edge(it->second);
+    print_edge(it->second, out);
   }
-  ss_out << std::endl << tab_1 << "]\n";
-  ss_out << "}" << std::endl;
+  out << "\n" << TAB_1 << "]\n";
+  out << "}\n";
+}
+
+std::string GraphPrinter::print() const {
+  std::stringstream ss_out;
+  print(ss_out);
   return ss_out.str();
 }
 }  // namespace uni_cpp_practice
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <iosfwd>
+#include <string>
 #include "graph.hpp"
 
 namespace uni_cpp_practice {
@@ -9,6 +11,8 @@ class GraphPrinter {
   explicit GraphPrinter(const Graph& graph) : graph_(graph){};
 
   std::string print() const;
+  // Пишет JSON прямо в поток, не собирая его в одну строку
+  void print(std::ostream& out) const;
 
  private:
   const Graph& graph_;
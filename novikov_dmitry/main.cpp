@@ -1,9 +1,10 @@
-#include <chrono>
 #include <filesystem>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <string>
 #include <vector>
+#include "date_time.hpp"
 #include "graph.hpp"
 #include "graph_generation_controller.hpp"
 #include "graph_generator.hpp"
@@ -14,15 +15,6 @@ const std::string temp_folder_path = "./temp";
 const std::string filename_prefix = "Graph";
 const std::string filename_suffix = ".json";
 
-std::string get_current_date_time() {
-  const auto date_time = std::chrono::system_clock::now();
-  const auto date_time_t = std::chrono::system_clock::to_time_t(date_time);
-  std::stringstream date_time_string;
-  date_time_string << std::put_time(std::localtime(&date_time_t),
-                                    "%Y.%m.%d %H:%M:%S");
-  return date_time_string.str();
-}
-
 std::vector<std::pair<uni_cpp_practice::Edge::Color, int>>
 set_count_edges_of_color(const uni_cpp_practice::Graph& graph) {
   std::vector<std::pair<uni_cpp_practice::Edge::Color, int>> colors = {
@@ -39,17 +31,21 @@ set_count_edges_of_color(const uni_cpp_practice::Graph& graph) {
   return colors;
 }
 
+// Время дописывается из кеша текущей секунды потока, без stringstream
 std::string gen_started_string(int graph_numbe) {
-  std::stringstream log_string;
-  log_string << get_current_date_time() << ": Graph " << graph_numbe + 1
-             << ", Generation Started\n";
-  return log_string.str();
+  std::string log_string;
+  uni_cpp_practice::date_time::append_date_time(log_string);
+  log_string += ": Graph " + std::to_string(graph_numbe + 1) +
+                ", Generation Started\n";
+  return log_string;
 }
 
 std::string gen_finished_string(int graph_numbe,
                                 const uni_cpp_practice::Graph& graph) {
+  std::string date_time;
+  uni_cpp_practice::date_time::append_date_time(date_time);
   std::stringstream log_string;
-  log_string << get_current_date_time() << ": Graph " << graph_numbe + 1
+  log_string << date_time << ": Graph " << graph_numbe + 1
              << ", Generation Finished {  \n";
   log_string << "  depth: " << graph.get_depth() << ",\n";
   log_string << "  vertices: " << graph.get_vertex_map().size() << ", [";
@@ -138,7 +134,7 @@ void write_to_file(const uni_cpp_practice::GraphPrinter& graph_printer,
   if (!file_out.is_open()) {
     std::cerr << "Error opening the file " << filename;
   } else {
-    file_out << graph_printer.print();
+    graph_printer.print(file_out);
     file_out.close();
   }
 }
@@ -157,6 +153,7 @@ int main() {
   auto generation_controller =
       GraphGenerationController(threads_count, graphs_count, params);
   auto& logger = prepare_logger();
+  logger.log("Seed: " + std::to_string(params.seed) + "\n");
 
   auto graphs = std::vector<Graph>();
   graphs.reserve(graphs_count);
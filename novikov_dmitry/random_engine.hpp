@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace uni_cpp_practice {
+
+namespace random_engine {
+
+// xoshiro256** seeded through splitmix64: 32 bytes of state and a handful of
+// instructions per draw, compatible with the <random> distributions.
+class Engine {
+ public:
+  using result_type = uint64_t;
+
+  explicit Engine(uint64_t seed = 0, uint64_t stream = 0) {
+    reseed(seed, stream);
+  }
+
+  // Different `stream` values with the same `seed` give independent
+  // sequences, so every job of one graph can own its own substream.
+  void reseed(uint64_t seed, uint64_t stream = 0);
+
+  result_type operator()();
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return UINT64_MAX; }
+
+  // Uniform in [0, 1).
+  double get_real() { return ((*this)() >> 11) * 0x1.0p-53; }
+
+  // Uniform in [0, upper_bound].
+  int get_int(int upper_bound);
+
+  bool get_bool(double probability) { return get_real() < probability; }
+
+ private:
+  std::array<uint64_t, 4> state_;
+};
+
+uint64_t mix_seed(uint64_t seed, uint64_t stream);
+
+}  // namespace random_engine
+
+}  // namespace uni_cpp_practice
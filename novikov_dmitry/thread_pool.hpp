@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace uni_cpp_practice {
+
+class ThreadPool {
+ public:
+  using JobCallback = std::function<void()>;
+
+  class Worker {
+   public:
+    explicit Worker(ThreadPool& thread_pool, int index)
+        : thread_pool_(thread_pool), index_(index){};
+
+    void start();
+    void join();
+
+    void push_job(JobCallback job);
+    // Owner takes jobs from the front, thieves from the back, so a batch
+    // submitted in order is mostly started in order.
+    std::optional<JobCallback> pop_job();
+    std::optional<JobCallback> steal_job();
+
+    ThreadPool& get_thread_pool() const { return thread_pool_; }
+
+   private:
+    ThreadPool& thread_pool_;
+    const int index_;
+    std::thread thread_;
+    std::deque<JobCallback> jobs_;
+    std::mutex mutex_jobs_;
+  };
+
+  // Process-wide pool with one worker per hardware thread. The controller
+  // and the generators of every graph submit into it, so no thread is
+  // created or destroyed while a batch is generated.
+  static ThreadPool& get_thread_pool() {
+    static ThreadPool thread_pool(
+        std::max(1u, std::thread::hardware_concurrency()));
+    return thread_pool;
+  }
+
+  explicit ThreadPool(int threads_count);
+
+  // A job submitted from one of the workers goes to its own queue, other
+  // threads spread jobs over all the workers.
+  void submit(JobCallback job);
+
+  int get_threads_count() const { return workers_.size(); }
+
+  ~ThreadPool();
+
+ private:
+  friend class TaskGroup;
+
+  std::deque<Worker> workers_;
+  std::atomic<int> next_worker_index_ = 0;
+
+  // Idle workers and waiting task groups park on `cv_sleep_` until
+  // `pending_jobs_` becomes non zero or a group is completed.
+  std::mutex mutex_sleep_;
+  std::condition_variable cv_sleep_;
+  std::atomic<int> pending_jobs_ = 0;
+  bool should_terminate_ = false;
+
+  Worker* get_current_worker() const;
+  std::optional<JobCallback> take_job();
+  bool run_pending_job();
+  void notify_all();
+  void run_worker(Worker& worker);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  ThreadPool& operator=(ThreadPool&&) = delete;
+};
+
+// Fork/join scope: `run` forks a job into the pool, `wait` joins all of
+// them. A waiting thread runs the group's own queued jobs first. A pool
+// worker then goes on with any queued job, so nested groups cannot starve
+// the pool. Any other thread only blocks, it must not pick up a job that
+// may in turn wait on that thread.
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool& thread_pool = ThreadPool::get_thread_pool())
+      : thread_pool_(thread_pool), state_(std::make_shared<State>()) {}
+
+  void run(ThreadPool::JobCallback job);
+  void wait();
+
+  ~TaskGroup() { wait(); }
+
+ private:
+  // Shared with the pool jobs, which may still be queued after `wait`
+  // returned if the waiter ran their group jobs itself.
+  struct State {
+    std::mutex mutex_jobs;
+    std::deque<ThreadPool::JobCallback> jobs;
+    std::atomic<int> pending_jobs = 0;
+  };
+
+  ThreadPool& thread_pool_;
+  const std::shared_ptr<State> state_;
+
+  static bool run_own_job(ThreadPool& thread_pool, State& state);
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+};
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,190 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "file_writer.hpp"
+#include "frozen_graph.hpp"
+#include "graph.hpp"
+#include "graph_generator.hpp"
+#include "graph_printing.hpp"
+#include "logger.hpp"
+#include "random_engine.hpp"
+
+namespace {
+
+using uni_cpp_practice::Edge;
+using uni_cpp_practice::FileWriter;
+using uni_cpp_practice::FrozenGraph;
+using uni_cpp_practice::Graph;
+using uni_cpp_practice::GraphGenerator;
+using uni_cpp_practice::Logger;
+using uni_cpp_practice::VertexId;
+
+// Fixed, so every run measures the same graphs.
+constexpr uint64_t SEED = 1;
+// Graphs expected to be larger take too long to build again and again.
+constexpr double MAX_EXPECTED_EDGES_NUM = 1 << 22;
+constexpr int IS_CONNECTED_QUERIES_NUM = 1 << 12;
+const std::string NULL_DEVICE = "/dev/null";
+
+// Depths 2..14 by new_vertices_num 1..10, without the ones too large. The
+// generator and the parallel printer work on the pool, so rates are by the
+// wall clock.
+void add_graph_sizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"depth", "new_vertices"})->UseRealTime();
+  for (int depth = 2; depth <= 14; depth += 3)
+    for (const int new_vertices_num : {1, 2, 4, 7, 10})
+      if (GraphGenerator::estimate_size(
+              GraphGenerator::Params(depth, new_vertices_num, SEED))
+              .expected_edges_num <= MAX_EXPECTED_EDGES_NUM)
+        benchmark->Args({depth, new_vertices_num});
+}
+
+GraphGenerator::Params get_params(const benchmark::State& state) {
+  return GraphGenerator::Params(state.range(0), state.range(1), SEED);
+}
+
+void set_graph_counters(benchmark::State& state,
+                        int64_t vertices_num,
+                        int64_t edges_num) {
+  state.counters["vertices/s"] =
+      benchmark::Counter(vertices_num, benchmark::Counter::kIsRate);
+  state.counters["edges/s"] =
+      benchmark::Counter(edges_num, benchmark::Counter::kIsRate);
+}
+
+void BM_Generate(benchmark::State& state) {
+  const GraphGenerator generator(get_params(state));
+  int graph_num = 0;
+  int64_t vertices_num = 0;
+  int64_t edges_num = 0;
+  for (auto _ : state) {
+    const Graph graph = generator.generate(graph_num++);
+    vertices_num += graph.get_vertices_num();
+    edges_num += graph.get_edges_num();
+  }
+  set_graph_counters(state, vertices_num, edges_num);
+}
+BENCHMARK(BM_Generate)->Apply(add_graph_sizes);
+
+void BM_GenerateGrayTree(benchmark::State& state) {
+  const GraphGenerator generator(get_params(state));
+  int graph_num = 0;
+  int64_t vertices_num = 0;
+  int64_t edges_num = 0;
+  for (auto _ : state) {
+    const Graph graph = generator.generate_gray_tree(graph_num++);
+    vertices_num += graph.get_vertices_num();
+    edges_num += graph.get_edges_num();
+  }
+  set_graph_counters(state, vertices_num, edges_num);
+}
+BENCHMARK(BM_GenerateGrayTree)->Apply(add_graph_sizes);
+
+// One color pass over a fresh gray tree, only the pass is timed. The edges
+// counted are the ones it added.
+template <Edge::Color color>
+void BM_PaintEdges(benchmark::State& state) {
+  const GraphGenerator generator(get_params(state));
+  std::optional<Graph> graph;
+  int graph_num = 0;
+  int64_t vertices_num = 0;
+  int64_t edges_num = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    graph.reset();
+    graph.emplace(generator.generate_gray_tree(graph_num));
+    const int gray_edges_num = graph->get_edges_num();
+    state.ResumeTiming();
+
+    generator.paint_edges(*graph, graph_num++, color);
+    vertices_num += graph->get_vertices_num();
+    edges_num += graph->get_edges_num() - gray_edges_num;
+  }
+  set_graph_counters(state, vertices_num, edges_num);
+}
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Green)->Apply(add_graph_sizes);
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Blue)->Apply(add_graph_sizes);
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Yellow)->Apply(add_graph_sizes);
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Red)->Apply(add_graph_sizes);
+
+// Half of the pairs queried are edges, half are random vertices.
+void BM_IsConnected(benchmark::State& state) {
+  const Graph graph = GraphGenerator(get_params(state)).generate();
+  auto& engine = uni_cpp_practice::random_engine::get_thread_engine();
+  std::vector<std::pair<VertexId, VertexId>> pairs;
+  pairs.reserve(IS_CONNECTED_QUERIES_NUM);
+  for (int i = 0; i < IS_CONNECTED_QUERIES_NUM; i++) {
+    if (i % 2 == 0) {
+      const auto& edge = graph.get_edges()[engine() % graph.get_edges_num()];
+      pairs.emplace_back(edge.connected_vertices[0],
+                         edge.connected_vertices[1]);
+    } else {
+      pairs.emplace_back(engine() % graph.get_vertices_num(),
+                         engine() % graph.get_vertices_num());
+    }
+  }
+
+  for (auto _ : state)
+    for (const auto& [from_vertex_id, to_vertex_id] : pairs)
+      benchmark::DoNotOptimize(
+          graph.is_connected(from_vertex_id, to_vertex_id));
+  state.SetItemsProcessed(state.iterations() * pairs.size());
+}
+BENCHMARK(BM_IsConnected)->Apply(add_graph_sizes);
+
+template <void (*print)(const FrozenGraph&, FileWriter&)>
+void BM_PrintGraph(benchmark::State& state) {
+  const FrozenGraph graph(GraphGenerator(get_params(state)).generate());
+  int64_t bytes_num = 0;
+  for (auto _ : state) {
+    FileWriter writer(NULL_DEVICE);
+    print(graph, writer);
+    writer.close();
+    bytes_num += writer.get_written_size();
+  }
+  state.SetBytesProcessed(bytes_num);
+  set_graph_counters(state, state.iterations() * graph.get_vertices_num(),
+                     state.iterations() * graph.get_edges_num());
+}
+BENCHMARK_TEMPLATE(BM_PrintGraph, uni_cpp_practice::graph_printing::print_graph)
+    ->Apply(add_graph_sizes);
+BENCHMARK_TEMPLATE(BM_PrintGraph,
+                   uni_cpp_practice::graph_printing::print_graph_in_parallel)
+    ->Apply(add_graph_sizes);
+
+// Run once before the threads of a run start, and once after all of them
+// are done, so switching the output never races the records measured.
+void set_up_logger(const benchmark::State&) {
+  auto& logger = Logger::get_logger();
+  logger.set_stdout_enabled(false);
+  logger.set_output(NULL_DEVICE);
+}
+
+void tear_down_logger(const benchmark::State&) {
+  Logger::get_logger().flush();
+}
+
+// Sustained rate: once the ring is full `log` waits for the flush thread.
+void BM_LoggerLog(benchmark::State& state) {
+  auto& logger = Logger::get_logger();
+  const std::string record = "2026.01.01 12:00:00: Graph " +
+                             std::to_string(state.thread_index()) +
+                             ", Generation Started";
+  for (auto _ : state)
+    logger.log(record);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerLog)
+    ->Setup(set_up_logger)
+    ->Teardown(tear_down_logger)
+    ->Threads(1)
+    ->Threads(4);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,410 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bernoulli_mask.hpp"
+#include "file_writer.hpp"
+#include "frozen_graph.hpp"
+#include "graph_archive.hpp"
+#include "graph_binary.hpp"
+#include "graph_parsing.hpp"
+#include "graph_generator.hpp"
+#include "graph_printing.hpp"
+
+namespace {
+
+using uni_cpp_practice::Edge;
+using uni_cpp_practice::EdgeId;
+using uni_cpp_practice::FileWriter;
+using uni_cpp_practice::FrozenGraph;
+using uni_cpp_practice::GraphGenerator;
+using uni_cpp_practice::VertexId;
+using uni_cpp_practice::graph_archive::ENTRY_SIZE;
+
+// Fixed, so a failure can be replayed.
+constexpr uint64_t SEED = 1;
+const std::string DIRECTORY_NAME = "temp";
+const std::string ARCHIVE_FILENAME = "temp/check.archive";
+const std::string JSON_FILENAME = "temp/check.json";
+const std::string BINARY_FILENAME = "temp/check.bin";
+
+void expect(bool condition, const std::string& what) {
+  if (!condition)
+    throw std::runtime_error("Check failed: " + what);
+}
+
+template <typename Exception, typename Callback>
+void expect_throws(const Callback& callback, const std::string& what) {
+  try {
+    callback();
+  } catch (const Exception&) {
+    return;
+  }
+  throw std::runtime_error("Check failed, nothing thrown: " + what);
+}
+
+std::string read_file(const std::string& file_path) {
+  std::ifstream file(file_path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+void write_file(const std::string& file_path, const std::string& bytes) {
+  FileWriter writer(file_path);
+  writer.write(bytes);
+  writer.close();
+}
+
+std::string print_graph(const FrozenGraph& graph) {
+  FileWriter writer(JSON_FILENAME);
+  uni_cpp_practice::graph_printing::print_graph(graph, writer);
+  writer.close();
+  return read_file(JSON_FILENAME);
+}
+
+// Only the random streams decide a graph, not the threads that draw them or
+// the memory it is built in.
+void check_generation_is_reproducible() {
+  for (const auto& [depth, new_vertices_num] :
+       std::vector<std::pair<int, int>>{{0, 3}, {3, 1}, {6, 3}, {9, 5}}) {
+    for (const bool batch_sampling : {true, false}) {
+      auto default_params =
+          GraphGenerator::Params(depth, new_vertices_num, SEED);
+      default_params.batch_sampling = batch_sampling;
+      for (int graph_num = 0; graph_num < 2; graph_num++) {
+        const auto expected_json = print_graph(
+            FrozenGraph(GraphGenerator(default_params).generate(graph_num)));
+        for (const bool run_on_calling_thread : {false, true}) {
+          for (const bool use_arena : {false, true}) {
+            auto params = default_params;
+            params.run_on_calling_thread = run_on_calling_thread;
+            params.use_arena = use_arena;
+            expect(print_graph(FrozenGraph(
+                       GraphGenerator(params).generate(graph_num))) ==
+                       expected_json,
+                   "graph " + std::to_string(graph_num) + " at depth " +
+                       std::to_string(depth) + " with " +
+                       std::to_string(new_vertices_num) +
+                       " new vertices generated again");
+          }
+        }
+      }
+    }
+  }
+}
+
+// Lengths around whole words, so the scalar tail after the vector loop is
+// covered too.
+void check_bernoulli_mask_kernels() {
+#ifdef BERNOULLI_MASK_AVX2
+  namespace detail = uni_cpp_practice::bernoulli_mask::detail;
+  if (!detail::has_avx2())
+    return;
+  for (const double probability : {0.001, 0.1, 0.5, 0.9, 0.999}) {
+    const auto threshold = static_cast<uint32_t>(probability * 0x1.0p32);
+    for (const size_t trials_num : {1, 7, 63, 64, 65, 200, 1000}) {
+      for (const uint32_t first_counter : {0u, 13u, UINT32_MAX - 100}) {
+        const uint64_t key = SEED * trials_num + first_counter;
+        std::vector<uint64_t> scalar_words((trials_num + 63) / 64);
+        std::vector<uint64_t> avx2_words(scalar_words.size());
+        detail::fill_scalar(scalar_words.data(), trials_num, threshold, key,
+                            first_counter);
+        detail::fill_avx2(avx2_words.data(), trials_num, threshold, key,
+                          first_counter);
+        expect(avx2_words == scalar_words,
+               "AVX2 mask of " + std::to_string(trials_num) +
+                   " trials with probability " + std::to_string(probability));
+      }
+    }
+  }
+#endif
+}
+
+// Graphs are written out of order and with two sets of params, the last
+// one large enough for the parallel printer to split it in chunks.
+void check_archive_round_trip() {
+  std::vector<GraphGenerator::Params> params = {
+      GraphGenerator::Params(4, 3, SEED), GraphGenerator::Params(9, 5, SEED)};
+  params[1].batch_sampling = false;
+  const std::vector<std::pair<int, int>> graphs = {
+      {3, 0}, {0, 0}, {5, 1}, {1, 0}, {4, 0}, {2, 0}};
+
+  std::vector<std::string> expected_jsons(graphs.size());
+  uni_cpp_practice::graph_archive::Writer writer(ARCHIVE_FILENAME);
+  for (const auto& [graph_num, params_index] : graphs) {
+    const auto graph = FrozenGraph(
+        GraphGenerator(params[params_index]).generate(graph_num));
+    expected_jsons[graph_num] = print_graph(graph);
+    writer.write_graph(graph, graph_num, params[params_index]);
+  }
+  writer.close();
+
+  const uni_cpp_practice::graph_archive::Reader reader(ARCHIVE_FILENAME);
+  expect(reader.get_graphs_num() == static_cast<int>(graphs.size()),
+         "archive graphs number");
+  for (const auto& [graph_num, params_index] : graphs) {
+    const auto& entry = reader.get_entries()[graph_num];
+    const auto& graph_params = params[params_index];
+    expect(entry.graph_num == graph_num, "archive entries are sorted");
+    expect(entry.seed == graph_params.seed &&
+               entry.depth == graph_params.depth &&
+               entry.new_vertices_num == graph_params.new_vertices_num &&
+               entry.flags == (graph_params.batch_sampling
+                                   ? uni_cpp_practice::graph_archive::
+                                         BATCH_SAMPLING_FLAG
+                                   : 0),
+           "archive entry params");
+    expect(reader.read_graph(graph_num) == expected_jsons[graph_num],
+           "archived graph " + std::to_string(graph_num) + " bytes");
+  }
+  const int missing_graph_num = graphs.size();
+  expect_throws<std::out_of_range>(
+      [&reader, missing_graph_num]() { reader.read_graph(missing_graph_num); },
+      "reading a graph the archive does not have");
+}
+
+void check_archive_index() {
+  {
+    uni_cpp_practice::graph_archive::Writer writer(ARCHIVE_FILENAME);
+    writer.close();
+  }
+  expect(uni_cpp_practice::graph_archive::Reader(ARCHIVE_FILENAME)
+                 .get_graphs_num() == 0,
+         "empty archive");
+
+  {
+    const auto params = GraphGenerator::Params(3, 2, SEED);
+    uni_cpp_practice::graph_archive::Writer writer(ARCHIVE_FILENAME);
+    for (int graph_num = 0; graph_num < 2; graph_num++)
+      writer.write_graph(
+          FrozenGraph(GraphGenerator(params).generate(graph_num)), graph_num,
+          params);
+    writer.close();
+  }
+  const auto archive = read_file(ARCHIVE_FILENAME);
+  const auto expect_rejected = [](const std::string& bytes,
+                                  const std::string& what) {
+    write_file(ARCHIVE_FILENAME, bytes);
+    expect_throws<std::runtime_error>(
+        []() { uni_cpp_practice::graph_archive::Reader{ARCHIVE_FILENAME}; },
+        what);
+  };
+  expect_rejected(archive.substr(0, archive.size() - 1), "truncated trailer");
+  expect_rejected(archive.substr(0, 8), "archive without an index");
+
+  // The trailer is the index offset, the graphs number and the magic.
+  auto wrong_graphs_num = archive;
+  wrong_graphs_num[archive.size() - 16]++;
+  expect_rejected(wrong_graphs_num, "graphs number beyond the index");
+  auto wrong_magic = archive;
+  wrong_magic.back() = '?';
+  expect_rejected(wrong_magic, "trailer without the magic");
+
+  const auto with_uint64 = [&archive](size_t offset, uint64_t value) {
+    auto bytes = archive;
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+    return bytes;
+  };
+  const size_t graphs_num_offset = archive.size() - 16;
+  const size_t index_offset = archive.size() - 24 - 2 * ENTRY_SIZE;
+  // Times the entry size, it wraps around to the size of the two entries.
+  expect_rejected(with_uint64(graphs_num_offset, (uint64_t{1} << 61) + 2),
+                  "graphs number overflowing the index size");
+  expect_rejected(with_uint64(archive.size() - 24, 0),
+                  "index offset inside the leading magic");
+  // An entry is the offset, the length and the seed, then the graph number.
+  expect_rejected(with_uint64(index_offset, 0),
+                  "graph inside the leading magic");
+  expect_rejected(with_uint64(index_offset + 8, UINT64_MAX),
+                  "graph length beyond the index");
+  expect_rejected(with_uint64(index_offset + ENTRY_SIZE, index_offset + 1),
+                  "graph starting beyond the index");
+  auto repeated_graph_num = archive;
+  repeated_graph_num[index_offset + ENTRY_SIZE + 24] = 0;
+  expect_rejected(repeated_graph_num, "repeated graph number");
+}
+
+void check_binary_round_trip() {
+  const auto graph = FrozenGraph(
+      GraphGenerator(GraphGenerator::Params(7, 4, SEED)).generate(0));
+  uni_cpp_practice::graph_binary::write_graph(graph, BINARY_FILENAME);
+  const uni_cpp_practice::graph_binary::MappedGraph mapped_graph(
+      BINARY_FILENAME);
+
+  expect(mapped_graph.get_depth() == graph.get_depth() &&
+             mapped_graph.get_vertices_num() == graph.get_vertices_num() &&
+             mapped_graph.get_edges_num() == graph.get_edges_num(),
+         "mapped graph sizes");
+  for (int color = 0; color < Edge::COLORS_NUM; color++)
+    expect(mapped_graph.get_edges_num(static_cast<Edge::Color>(color)) ==
+               graph.get_edges_num(static_cast<Edge::Color>(color)),
+           "mapped edges number of a color");
+  for (int depth = 0; depth <= graph.get_depth(); depth++)
+    expect(mapped_graph.get_vertices_num_at_depth(depth) ==
+               graph.get_vertices_num_at_depth(depth),
+           "mapped vertices number at depth");
+
+  for (VertexId vertex_id = 0; vertex_id < graph.get_vertices_num();
+       vertex_id++) {
+    expect(mapped_graph.get_vertex_depth(vertex_id) ==
+               graph.get_vertex_depth(vertex_id),
+           "mapped vertex depth");
+    expect(std::equal(graph.get_edge_ids(vertex_id).begin(),
+                      graph.get_edge_ids(vertex_id).end(),
+                      mapped_graph.get_edge_ids(vertex_id).begin(),
+                      mapped_graph.get_edge_ids(vertex_id).end()),
+           "mapped edge ids");
+    expect(std::equal(graph.get_neighbour_ids(vertex_id).begin(),
+                      graph.get_neighbour_ids(vertex_id).end(),
+                      mapped_graph.get_neighbour_ids(vertex_id).begin(),
+                      mapped_graph.get_neighbour_ids(vertex_id).end()),
+           "mapped neighbour ids");
+  }
+  for (EdgeId edge_id = 0; edge_id < graph.get_edges_num(); edge_id++)
+    expect(mapped_graph.get_edge_vertices(edge_id) ==
+                   graph.get_edge_vertices(edge_id) &&
+               mapped_graph.get_edge_color(edge_id) ==
+                   graph.get_edge_color(edge_id),
+           "mapped edge");
+}
+
+void check_binary_corruption() {
+  const auto graph = FrozenGraph(
+      GraphGenerator(GraphGenerator::Params(3, 2, SEED)).generate(0));
+  uni_cpp_practice::graph_binary::write_graph(graph, BINARY_FILENAME);
+  const auto binary = read_file(BINARY_FILENAME);
+  const auto expect_rejected = [](const std::string& bytes,
+                                  const std::string& what) {
+    write_file(BINARY_FILENAME, bytes);
+    expect_throws<std::runtime_error>(
+        []() {
+          uni_cpp_practice::graph_binary::MappedGraph{BINARY_FILENAME};
+        },
+        what);
+  };
+  const auto with_int32 = [&binary](size_t offset, int32_t value) {
+    auto bytes = binary;
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+    return bytes;
+  };
+
+  expect_rejected(binary.substr(0, binary.size() - 1), "truncated file");
+  expect_rejected(binary.substr(0, 10), "file shorter than the header");
+  expect_rejected(binary + std::string(8, '\0'), "file with extra bytes");
+  expect_rejected(
+      with_int32(offsetof(uni_cpp_practice::graph_binary::Header, depth), -1),
+      "negative depth");
+  expect_rejected(with_int32(offsetof(uni_cpp_practice::graph_binary::Header,
+                                      vertices_num),
+                             graph.get_vertices_num() + 1),
+                  "more vertices than the file has");
+
+  // The edge offsets follow the vertices number at every depth and the
+  // vertex depths, each section aligned to 8 bytes.
+  const auto align = [](size_t offset) { return (offset + 7) / 8 * 8; };
+  const size_t edge_offsets_offset =
+      align(align(sizeof(uni_cpp_practice::graph_binary::Header) +
+                  (graph.get_depth() + 1) * sizeof(int32_t)) +
+            graph.get_vertices_num() * sizeof(int32_t));
+  expect_rejected(
+      with_int32(edge_offsets_offset + sizeof(int32_t), INT32_MAX),
+      "edge offsets beyond the adjacency");
+  expect_rejected(with_int32(edge_offsets_offset, 1),
+                  "edge offsets not starting at zero");
+}
+
+void check_parse_round_trip() {
+  for (const int new_vertices_num : {0, 1, 4}) {
+    const auto graph = FrozenGraph(
+        GraphGenerator(GraphGenerator::Params(6, new_vertices_num, SEED))
+            .generate(0));
+    const auto json = print_graph(graph);
+    expect(print_graph(FrozenGraph(
+               uni_cpp_practice::graph_parsing::parse_graph(json))) == json,
+           "parsed graph printed again");
+    expect(print_graph(FrozenGraph(uni_cpp_practice::graph_parsing::read_graph(
+               JSON_FILENAME, true))) == json,
+           "graph read from a file into an arena printed again");
+  }
+}
+
+void check_parse_errors() {
+  // Gray edges 0 and 1 from the root, a green one between its children.
+  const std::string json = R"({ "depth": 1, "vertices": [
+      { "id": 0, "edge_ids": [0, 1] },
+      { "id": 1, "edge_ids": [0, 2] },
+      { "id": 2, "edge_ids": [1, 2] } ], "edges": [
+      { "id": 0, "vertex_ids": [0, 1], "color": "gray" },
+      { "id": 1, "vertex_ids": [0, 2], "color": "gray" },
+      { "id": 2, "vertex_ids": [1, 2], "color": "green" } ] })";
+  expect(uni_cpp_practice::graph_parsing::parse_graph(json).get_edges_num() ==
+             3,
+         "hand written graph");
+
+  const auto expect_rejected = [&json](const std::string& from,
+                                       const std::string& to,
+                                       const std::string& error) {
+    auto bad_json = json;
+    bad_json.replace(bad_json.find(from), from.size(), to);
+    try {
+      uni_cpp_practice::graph_parsing::parse_graph(bad_json);
+    } catch (const std::runtime_error& exception) {
+      expect(std::string(exception.what()).find(error) != std::string::npos,
+             "\"" + error + "\" in \"" + exception.what() + "\"");
+      return;
+    }
+    throw std::runtime_error("Check failed, nothing thrown: " + error);
+  };
+  expect_rejected(R"("vertex_ids": [1, 2])", R"("vertex_ids": [0, 1])",
+                  "edge 2 is a duplicate");
+  expect_rejected(R"("id": 1, "edge_ids")", R"("id": 2, "edge_ids")",
+                  "expected vertex 1");
+  expect_rejected(R"("id": 2, "vertex_ids")", R"("id": 3, "vertex_ids")",
+                  "expected edge 2");
+  expect_rejected(R"("depth": 1)", R"("depth": 2)",
+                  "depth 2 does not match the vertices");
+  expect_rejected(R"("color": "green")", R"("color": "purple")",
+                  "unknown color \"purple\"");
+  expect_rejected(R"("edge_ids": [1, 2])", R"("edge_ids": [1])",
+                  "edge ids of vertex 2 do not match its edges");
+  expect_rejected(R"("edge_ids": [0, 2])", R"("edge_ids": [0, 1])",
+                  "edge ids of vertex 1 do not match its edges");
+  expect_rejected(R"("edge_ids": [1, 2] })",
+                  R"("edge_ids": [1, 2], "depth": 2 })",
+                  "vertex 2 has depth 2, its gray edges give 1");
+  expect_rejected(R"("vertex_ids": [0, 2], "color": "gray")",
+                  R"("vertex_ids": [0, 2], "color": "blue")",
+                  "vertex 2 is not reached by gray edges");
+}
+
+}  // namespace
+
+// Reproducibility and round trips of the file formats, `make check` runs
+// them.
+int main() {
+  std::filesystem::create_directory(DIRECTORY_NAME);
+  try {
+    check_generation_is_reproducible();
+    check_bernoulli_mask_kernels();
+    check_archive_round_trip();
+    check_archive_index();
+    check_binary_round_trip();
+    check_binary_corruption();
+    check_parse_round_trip();
+    check_parse_errors();
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
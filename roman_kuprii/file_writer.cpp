@@ -0,0 +1,93 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "file_writer.hpp"
+
+namespace {
+
+// Enough for any int with its sign.
+constexpr size_t MAX_NUMBER_LENGTH = 11;
+
+}  // namespace
+
+namespace uni_cpp_practice {
+
+FileWriter::FileWriter(const std::string& file_path)
+    : file_descriptor_(
+          ::open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) {
+  if (file_descriptor_ == -1)
+    throw std::runtime_error("Failed to open " + file_path);
+}
+
+void FileWriter::write(std::string_view text) {
+  if (buffer_size_ + text.size() > BUFFER_SIZE)
+    flush();
+  if (text.size() > BUFFER_SIZE) {
+    if (!write_all(text.data(), text.size()))
+      throw std::runtime_error("Failed to write file");
+    return;
+  }
+  std::memcpy(buffer_.data() + buffer_size_, text.data(), text.size());
+  buffer_size_ += text.size();
+}
+
+void FileWriter::write(int number) {
+  if (buffer_size_ + MAX_NUMBER_LENGTH > BUFFER_SIZE)
+    flush();
+  char* const begin = buffer_.data() + buffer_size_;
+  buffer_size_ +=
+      std::to_chars(begin, begin + MAX_NUMBER_LENGTH, number).ptr - begin;
+}
+
+void FileWriter::flush() {
+  const size_t size = buffer_size_;
+  buffer_size_ = 0;
+  if (!write_all(buffer_.data(), size))
+    throw std::runtime_error("Failed to write file");
+}
+
+void FileWriter::close() {
+  if (file_descriptor_ == -1)
+    return;
+  flush();
+  const int file_descriptor = file_descriptor_;
+  file_descriptor_ = -1;
+  if (::close(file_descriptor) == -1)
+    throw std::runtime_error("Failed to close file");
+}
+
+bool FileWriter::write_all(const char* data, size_t size) {
+  const auto start = std::chrono::steady_clock::now();
+  bool is_written = true;
+  while (size > 0) {
+    const ssize_t written = ::write(file_descriptor_, data, size);
+    if (written == -1) {
+      if (errno == EINTR)
+        continue;
+      is_written = false;
+      break;
+    }
+    data += written;
+    size -= written;
+    flushed_size_ += written;
+  }
+  write_duration_ += std::chrono::steady_clock::now() - start;
+  return is_written;
+}
+
+FileWriter::~FileWriter() {
+  if (file_descriptor_ == -1)
+    return;
+  write_all(buffer_.data(), buffer_size_);
+  ::close(file_descriptor_);
+}
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace uni_cpp_practice {
+
+// Writes straight to a file descriptor through one fixed buffer, so the
+// memory used does not depend on how much is written.
+class FileWriter {
+ public:
+  static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+  explicit FileWriter(const std::string& file_path);
+
+  void write(std::string_view text);
+  void write(int number);
+
+  // Bytes written so far, the buffered ones included.
+  uint64_t get_written_size() const { return flushed_size_ + buffer_size_; }
+  // Time spent in write calls so far.
+  std::chrono::nanoseconds get_write_duration() const {
+    return write_duration_;
+  }
+
+  void flush();
+  // Flushes and closes the file, reporting errors unlike the destructor.
+  void close();
+
+  ~FileWriter();
+
+ private:
+  int file_descriptor_ = -1;
+  uint64_t flushed_size_ = 0;
+  std::chrono::nanoseconds write_duration_ = {};
+  size_t buffer_size_ = 0;
+  std::array<char, BUFFER_SIZE> buffer_;
+
+  bool write_all(const char* data, size_t size);
+
+  FileWriter(const FileWriter&) = delete;
+  FileWriter& operator=(const FileWriter&) = delete;
+  FileWriter(FileWriter&&) = delete;
+  FileWriter& operator=(FileWriter&&) = delete;
+};
+
+}  // namespace uni_cpp_practice
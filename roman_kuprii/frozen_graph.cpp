@@ -0,0 +1,50 @@
+#include <vector>
+
+#include "frozen_graph.hpp"
+#include "graph.hpp"
+
+namespace uni_cpp_practice {
+
+FrozenGraph::FrozenGraph(const Graph& graph) : depth_(graph.get_depth()) {
+  const auto& vertices = graph.get_vertices();
+  const auto& edges = graph.get_edges();
+
+  vertex_depths_.reserve(vertices.size());
+  edge_offsets_.reserve(vertices.size() + 1);
+  // Every edge but a loop is listed by both of its vertices.
+  const size_t adjacency_size =
+      2 * edges.size() - graph.get_edges_num(Edge::Color::Green);
+  edge_ids_.reserve(adjacency_size);
+  neighbour_ids_.reserve(adjacency_size);
+
+  edge_offsets_.push_back(0);
+  for (const auto& vertex : vertices) {
+    vertex_depths_.push_back(vertex.depth);
+    for (const auto& edge_id : vertex.get_edges_ids()) {
+      // Edge ids are dense and equal to the index in `edges`.
+      const auto& connected_vertices = edges[edge_id].connected_vertices;
+      edge_ids_.push_back(edge_id);
+      neighbour_ids_.push_back(connected_vertices[0] == vertex.get_id()
+                                   ? connected_vertices[1]
+                                   : connected_vertices[0]);
+    }
+    edge_offsets_.push_back(edge_ids_.size());
+  }
+
+  vertices_num_at_depth_.reserve(depth_ + 1);
+  for (int depth = 0; depth <= depth_; depth++)
+    vertices_num_at_depth_.push_back(
+        graph.get_vertices_at_depth(depth).size());
+
+  edge_vertices_.reserve(edges.size());
+  edge_colors_.reserve(edges.size());
+  for (const auto& edge : edges) {
+    edge_vertices_.push_back(edge.connected_vertices);
+    edge_colors_.push_back(edge.color);
+  }
+  for (int color = 0; color < Edge::COLORS_NUM; color++)
+    edges_num_by_color_[color] =
+        graph.get_edges_num(static_cast<Edge::Color>(color));
+}
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace uni_cpp_practice {
+
+// View of `size` consecutive values, the C++17 stand-in for std::span.
+template <typename T>
+class ConstSpan {
+ public:
+  ConstSpan(const T* data, size_t size) : data_(data), size_(size) {}
+
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const T& operator[](size_t index) const { return data_[index]; }
+
+ private:
+  const T* data_;
+  size_t size_;
+};
+
+// Read-only copy of a finished Graph in compressed sparse row form. The
+// edges of vertex `v` are the entries `[edge_offsets_[v], edge_offsets_[v +
+// 1])` of `edge_ids_` and `neighbour_ids_`, every other field is a column
+// indexed by the vertex or the edge id. A few flat arrays replace one heap
+// block per vertex and the pair index, and walking them is sequential.
+class FrozenGraph {
+ public:
+  explicit FrozenGraph(const Graph& graph);
+
+  int get_depth() const { return depth_; }
+  int get_vertices_num() const { return vertex_depths_.size(); }
+  int get_edges_num() const { return edge_colors_.size(); }
+  int get_edges_num(const Edge::Color& color) const {
+    return edges_num_by_color_[static_cast<int>(color)];
+  }
+  int get_vertices_num_at_depth(int depth) const {
+    assert(depth >= 0 && depth <= depth_);
+    return vertices_num_at_depth_[depth];
+  }
+
+  int get_vertex_depth(const VertexId& vertex_id) const {
+    return vertex_depths_[vertex_id];
+  }
+  // In the order the edges were connected to the vertex.
+  ConstSpan<EdgeId> get_edge_ids(const VertexId& vertex_id) const {
+    return get_row(edge_ids_, vertex_id);
+  }
+  // The other end of each of `get_edge_ids(vertex_id)`.
+  ConstSpan<VertexId> get_neighbour_ids(const VertexId& vertex_id) const {
+    return get_row(neighbour_ids_, vertex_id);
+  }
+
+  const std::array<VertexId, 2>& get_edge_vertices(
+      const EdgeId& edge_id) const {
+    return edge_vertices_[edge_id];
+  }
+  Edge::Color get_edge_color(const EdgeId& edge_id) const {
+    return edge_colors_[edge_id];
+  }
+
+ private:
+  int depth_ = 0;
+  std::vector<int> vertex_depths_;
+  std::vector<int> vertices_num_at_depth_;
+  std::vector<int> edge_offsets_;
+  std::vector<EdgeId> edge_ids_;
+  std::vector<VertexId> neighbour_ids_;
+  std::vector<std::array<VertexId, 2>> edge_vertices_;
+  std::vector<Edge::Color> edge_colors_;
+  std::array<int, Edge::COLORS_NUM> edges_num_by_color_ = {};
+
+  template <typename T>
+  ConstSpan<T> get_row(const std::vector<T>& column,
+                       const VertexId& vertex_id) const {
+    assert(vertex_id >= 0 && vertex_id < get_vertices_num());
+    const int begin = edge_offsets_[vertex_id];
+    return ConstSpan<T>(column.data() + begin,
+                        edge_offsets_[vertex_id + 1] - begin);
+  }
+};
+
+}  // namespace uni_cpp_practice
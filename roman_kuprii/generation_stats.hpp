@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace uni_cpp_practice {
+
+// Where the time of one graph went, from the gray tree to the file.
+struct GenerationStats {
+  enum class Phase {
+    Gray,
+    Green,
+    Blue,
+    Yellow,
+    Red,
+    Merge,
+    Serialize,
+    Write
+  };
+  static constexpr int PHASES_NUM = 8;
+  static constexpr std::array<std::string_view, PHASES_NUM> PHASE_NAMES = {
+      "gray", "green",  "blue",      "yellow",
+      "red",  "merge", "serialize", "write"};
+
+  // Gray and merge are wall time. The color passes run their slices side by
+  // side on the pool, each of them is summed over its slices. Merge adds the
+  // edges the slices found, one at a time. Write is the time in write calls
+  // made while the graph was printed, serialize the rest of the printing.
+  std::array<std::chrono::nanoseconds, PHASES_NUM> phase_durations = {};
+  // Values drawn from the random engine or from a Bernoulli mask.
+  uint64_t random_draws_num = 0;
+  // Requests the graph made to its memory resource, and their bytes.
+  uint64_t allocations_num = 0;
+  uint64_t allocated_size = 0;
+
+  std::chrono::nanoseconds& get_duration(const Phase& phase) {
+    return phase_durations[static_cast<int>(phase)];
+  }
+  const std::chrono::nanoseconds& get_duration(const Phase& phase) const {
+    return phase_durations[static_cast<int>(phase)];
+  }
+};
+
+}  // namespace uni_cpp_practice
@@ -1,20 +1,38 @@
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "graph.hpp"
 
 namespace {
 
-bool is_edge_id_included(
+[[maybe_unused]] bool is_edge_id_included(
     const uni_cpp_practice::EdgeId& id,
-    const std::vector<uni_cpp_practice::EdgeId>& edge_ids) {
+    const std::pmr::vector<uni_cpp_practice::EdgeId>& edge_ids) {
   for (const auto& edge_id : edge_ids)
     if (id == edge_id)
       return true;
   return false;
 }
 
+uint64_t pack_vertex_pair(const uni_cpp_practice::VertexId& first_vertex_id,
+                          const uni_cpp_practice::VertexId& second_vertex_id) {
+  const auto low =
+      static_cast<uint32_t>(std::min(first_vertex_id, second_vertex_id));
+  const auto high =
+      static_cast<uint32_t>(std::max(first_vertex_id, second_vertex_id));
+  return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+// First block of a graph arena, the following ones grow geometrically.
+constexpr size_t ARENA_INITIAL_SIZE = 1 << 16;
+
 using std::min;
 using std::to_string;
 using std::vector;
@@ -28,18 +46,69 @@ void Vertex::add_edge_id(const EdgeId& _id) {
   edges_ids_.push_back(_id);
 }
 
+Graph::Graph(bool use_arena)
+    : arena_(use_arena ? std::make_unique<std::pmr::monotonic_buffer_resource>(
+                             ARENA_INITIAL_SIZE)
+                       : nullptr),
+      memory_counter_(std::make_unique<CountingMemoryResource>(
+          arena_ ? arena_.get() : std::pmr::get_default_resource())),
+      vertices_(get_memory_resource()),
+      edges_(get_memory_resource()),
+      edge_ids_by_color_{std::pmr::vector<EdgeId>(get_memory_resource()),
+                         std::pmr::vector<EdgeId>(get_memory_resource()),
+                         std::pmr::vector<EdgeId>(get_memory_resource()),
+                         std::pmr::vector<EdgeId>(get_memory_resource()),
+                         std::pmr::vector<EdgeId>(get_memory_resource())},
+      connected_pairs_(get_memory_resource()),
+      depth_map_(get_memory_resource()) {
+  static_assert(Edge::COLORS_NUM == 5);
+  depth_map_.emplace_back();
+}
+
+void Graph::reserve(
+    int vertices_num,
+    const std::array<int, Edge::COLORS_NUM>& edges_num_by_color,
+    const std::vector<int>& layer_sizes) {
+  int edges_num = 0;
+  for (int color = 0; color < Edge::COLORS_NUM; color++) {
+    edge_ids_by_color_[color].reserve(edges_num_by_color[color]);
+    edges_num += edges_num_by_color[color];
+  }
+  vertices_.reserve(vertices_num);
+  edges_.reserve(edges_num);
+  connected_pairs_.reserve(edges_num);
+
+  if (layer_sizes.size() > depth_map_.size())
+    depth_map_.resize(layer_sizes.size());
+  for (size_t depth = 0; depth < layer_sizes.size(); depth++)
+    depth_map_[depth].reserve(layer_sizes[depth]);
+}
+
 VertexId Graph::add_vertex() {
   const VertexId new_vertex_id = get_next_vertex_id();
   vertices_.emplace_back(new_vertex_id);
+  depth_map_[0].push_back(new_vertex_id);
   return new_vertex_id;
 }
 
+void Graph::set_vertex_depth(const VertexId& vertex_id, int depth) {
+  auto& old_layer = depth_map_[vertices_[vertex_id].depth];
+  // The vertex is usually the last one added to its layer.
+  const auto position =
+      std::find(old_layer.rbegin(), old_layer.rend(), vertex_id);
+  assert(position != old_layer.rend());
+  old_layer.erase(std::next(position).base());
+
+  if (depth >= static_cast<int>(depth_map_.size()))
+    depth_map_.resize(depth + 1);
+  depth_map_[depth].push_back(vertex_id);
+  vertices_[vertex_id].depth = depth;
+  depth_ = std::max(depth_, depth);
+}
+
 bool Graph::is_vertex_exist(const VertexId& vertex_id) const {
-  for (const auto& vertex : vertices_) {
-    if (vertex_id == vertex.get_id())
-      return true;
-  }
-  return false;
+  // Vertex ids are dense and equal to the index in `vertices_`.
+  return vertex_id >= 0 && vertex_id < get_vertices_num();
 }
 
 bool Graph::is_connected(const VertexId& from_vertex_id,
@@ -47,20 +116,8 @@ bool Graph::is_connected(const VertexId& from_vertex_id,
   assert(is_vertex_exist(from_vertex_id));
   assert(is_vertex_exist(to_vertex_id));
 
-  const auto& from_vertex_edges_ids = vertices_[from_vertex_id].get_edges_ids();
-  const auto& to_vertex_edges_ids = vertices_[to_vertex_id].get_edges_ids();
-  for (const auto& from_vertex_edge_id : from_vertex_edges_ids)
-    if (from_vertex_id == to_vertex_id) {
-      const auto& connected_vertices =
-          edges_[from_vertex_edge_id].connected_vertices;
-      if (connected_vertices[0] == connected_vertices[1])
-        return true;
-    } else
-      for (const auto& to_vertex_edge_id : to_vertex_edges_ids)
-        if (from_vertex_edge_id == to_vertex_edge_id)
-          return true;
-
-  return false;
+  return connected_pairs_.count(
+             pack_vertex_pair(from_vertex_id, to_vertex_id)) > 0;
 }
 
 void Graph::connect_vertices(const VertexId& from_vertex_id,
@@ -80,8 +137,7 @@ void Graph::connect_vertices(const VertexId& from_vertex_id,
       }
       return min_depth;
     }();
-    vertices_[to_vertex_id].depth = minimum_depth + 1;
-    depth_ = std::max(depth_, minimum_depth + 1);
+    set_vertex_depth(to_vertex_id, minimum_depth + 1);
   }
 
   const int diff =
@@ -103,22 +159,85 @@ void Graph::connect_vertices(const VertexId& from_vertex_id,
       return Edge::Color::Gray;
   }();
 
+  add_edge(from_vertex_id, to_vertex_id, color);
+}
+
+EdgeId Graph::add_edge(const VertexId& from_vertex_id,
+                       const VertexId& to_vertex_id,
+                       const Edge::Color& color) {
+  assert(is_vertex_exist(from_vertex_id));
+  assert(is_vertex_exist(to_vertex_id));
+
+  if (!connected_pairs_.insert(pack_vertex_pair(from_vertex_id, to_vertex_id))
+           .second)
+    return INVALID_ID;
   const auto& new_edge = edges_.emplace_back(from_vertex_id, to_vertex_id,
                                              get_next_edge_id(), color);
+  edge_ids_by_color_[static_cast<int>(color)].push_back(new_edge.id);
   vertices_[from_vertex_id].add_edge_id(new_edge.id);
   if (from_vertex_id != to_vertex_id)
     vertices_[to_vertex_id].add_edge_id(new_edge.id);
+  return new_edge.id;
 }
 
-std::vector<EdgeId> Graph::get_edge_ids_with_color(
-    const Edge::Color& color) const {
-  std::vector<EdgeId> edge_ids;
-  for (const auto& edge : get_edges()) {
-    if (edge.color == color)
-      edge_ids.emplace_back(edge.id);
+void Graph::set_vertex_depths(const std::vector<int>& depths) {
+  assert(static_cast<int>(depths.size()) == get_vertices_num());
+  depth_ = 0;
+  for (const int depth : depths) {
+    assert(depth >= 0);
+    depth_ = std::max(depth_, depth);
+  }
+
+  std::vector<int> layer_sizes(depth_ + 1, 0);
+  for (const int depth : depths)
+    layer_sizes[depth]++;
+  depth_map_.resize(std::max<size_t>(depth_map_.size(), depth_ + 1));
+  for (size_t depth = 0; depth < depth_map_.size(); depth++) {
+    depth_map_[depth].clear();
+    if (depth < layer_sizes.size())
+      depth_map_[depth].reserve(layer_sizes[depth]);
   }
+  for (VertexId vertex_id = 0; vertex_id < get_vertices_num(); vertex_id++) {
+    vertices_[vertex_id].depth = depths[vertex_id];
+    depth_map_[depths[vertex_id]].push_back(vertex_id);
+  }
+}
 
-  return edge_ids;
+VertexId Graph::add_gray_layer(const std::vector<VertexId>& parent_ids) {
+  const VertexId first_vertex_id = vertex_id_counter_;
+  if (parent_ids.empty())
+    return first_vertex_id;
+
+  const int depth = depth_ + 1;
+  vertices_.reserve(vertices_.size() + parent_ids.size());
+  edges_.reserve(edges_.size() + parent_ids.size());
+  auto& gray_edge_ids =
+      edge_ids_by_color_[static_cast<int>(Edge::Color::Gray)];
+  gray_edge_ids.reserve(gray_edge_ids.size() + parent_ids.size());
+  if (depth >= static_cast<int>(depth_map_.size()))
+    depth_map_.resize(depth + 1);
+  auto& layer = depth_map_[depth];
+  layer.reserve(layer.size() + parent_ids.size());
+
+  // The depth of a new vertex is known, none of `connect_vertices`
+  // searching is needed.
+  for (const auto& parent_vertex_id : parent_ids) {
+    assert(is_vertex_exist(parent_vertex_id));
+    assert(vertices_[parent_vertex_id].depth == depth_);
+    const VertexId new_vertex_id = get_next_vertex_id();
+    vertices_.emplace_back(new_vertex_id).depth = depth;
+    layer.push_back(new_vertex_id);
+
+    const EdgeId new_edge_id = get_next_edge_id();
+    edges_.emplace_back(parent_vertex_id, new_vertex_id, new_edge_id,
+                        Edge::Color::Gray);
+    connected_pairs_.insert(pack_vertex_pair(parent_vertex_id, new_vertex_id));
+    gray_edge_ids.push_back(new_edge_id);
+    vertices_[parent_vertex_id].add_edge_id(new_edge_id);
+    vertices_[new_vertex_id].add_edge_id(new_edge_id);
+  }
+  depth_ = depth;
+  return first_vertex_id;
 }
 
 }  // namespace uni_cpp_practice
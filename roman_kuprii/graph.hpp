@@ -2,7 +2,13 @@
 
 #include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace uni_cpp_practice {
@@ -13,7 +19,8 @@ using VertexId = int;
 constexpr int INVALID_ID = -1;
 
 struct Edge {
-  enum class Color { Gray, Green, Blue, Yellow, Red };
+  enum class Color : uint8_t { Gray, Green, Blue, Yellow, Red };
+  static constexpr int COLORS_NUM = 5;
 
   const EdgeId id = INVALID_ID;
   const std::array<VertexId, 2> connected_vertices;
@@ -28,23 +35,81 @@ struct Edge {
 
 struct Vertex {
  public:
+  // Lets the vertices of a graph put their edge ids in the graph's memory.
+  using allocator_type = std::pmr::polymorphic_allocator<EdgeId>;
+
   int depth = 0;
 
-  explicit Vertex(const VertexId& _id) : id_(_id) {}
+  explicit Vertex(const VertexId& _id,
+                  const allocator_type& allocator = allocator_type())
+      : id_(_id), edges_ids_(allocator) {}
+  Vertex(const Vertex& vertex, const allocator_type& allocator)
+      : depth(vertex.depth),
+        id_(vertex.id_),
+        edges_ids_(vertex.edges_ids_, allocator) {}
+  Vertex(Vertex&& vertex, const allocator_type& allocator)
+      : depth(vertex.depth),
+        id_(vertex.id_),
+        edges_ids_(std::move(vertex.edges_ids_), allocator) {}
 
   void add_edge_id(const EdgeId& _id);
+  void reserve_edge_ids(int edges_num) { edges_ids_.reserve(edges_num); }
 
-  const std::vector<EdgeId>& get_edges_ids() const { return edges_ids_; }
+  const std::pmr::vector<EdgeId>& get_edges_ids() const { return edges_ids_; }
 
   const VertexId& get_id() const { return id_; }
 
  private:
   const VertexId id_ = INVALID_ID;
-  std::vector<EdgeId> edges_ids_;
+  std::pmr::vector<EdgeId> edges_ids_;
+};
+
+// Counts the requests passed on to `upstream`. Not thread safe, as a graph
+// is only ever changed by one thread at a time.
+class CountingMemoryResource : public std::pmr::memory_resource {
+ public:
+  explicit CountingMemoryResource(std::pmr::memory_resource* upstream)
+      : upstream_(upstream) {}
+
+  uint64_t get_allocations_num() const { return allocations_num_; }
+  uint64_t get_allocated_size() const { return allocated_size_; }
+
+ private:
+  std::pmr::memory_resource* const upstream_;
+  uint64_t allocations_num_ = 0;
+  uint64_t allocated_size_ = 0;
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    allocations_num_++;
+    allocated_size_ += bytes;
+    return upstream_->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* data, size_t bytes, size_t alignment) override {
+    upstream_->deallocate(data, bytes, alignment);
+  }
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
 };
 
 class Graph {
  public:
+  // With `use_arena` everything the graph allocates comes from one
+  // monotonic region owned by it. Growing vectors stop going through the
+  // global allocator, and the region is released in a few large blocks
+  // when the graph is destroyed.
+  explicit Graph(bool use_arena = false);
+
+  Graph(Graph&&) = default;
+  Graph& operator=(Graph&&) = delete;
+
+  // Makes room for that many vertices and edges of each color, and for
+  // `layer_sizes[d]` vertices at depth d.
+  void reserve(int vertices_num,
+               const std::array<int, Edge::COLORS_NUM>& edges_num_by_color,
+               const std::vector<int>& layer_sizes);
+
   VertexId add_vertex();
 
   bool is_vertex_exist(const VertexId& vertex_id) const;
@@ -56,23 +121,75 @@ class Graph {
                         const VertexId& to_vertex_id,
                         bool initialization);
 
-  const std::vector<Edge>& get_edges() const { return edges_; }
-  const std::vector<Vertex>& get_vertices() const { return vertices_; }
+  // Makes room for that many edges at the vertex.
+  void reserve_edges(const VertexId& vertex_id, int edges_num) {
+    assert(is_vertex_exist(vertex_id));
+    vertices_[vertex_id].reserve_edge_ids(edges_num);
+  }
+
+  // Adds an edge whose color is already known, as when a printed graph is
+  // read back. Vertex depths are left as they are. Returns INVALID_ID, and
+  // adds nothing, if the vertices are connected already.
+  EdgeId add_edge(const VertexId& from_vertex_id,
+                  const VertexId& to_vertex_id,
+                  const Edge::Color& color);
+
+  // Sets the depth of every vertex at once, `depths[vertex_id]`, and lays
+  // the layers out anew.
+  void set_vertex_depths(const std::vector<int>& depths);
+
+  // Adds a layer below the deepest one, the i-th new vertex hanging off
+  // `parent_ids[i]` by a gray edge. The new vertices and edges get
+  // consecutive ids in that order. Returns the id of the first new vertex.
+  VertexId add_gray_layer(const std::vector<VertexId>& parent_ids);
+
+  const std::pmr::vector<Edge>& get_edges() const { return edges_; }
+  const std::pmr::vector<Vertex>& get_vertices() const { return vertices_; }
+
+  const std::pmr::vector<VertexId>& get_vertices_at_depth(int depth) const {
+    assert(depth >= 0 && depth < static_cast<int>(depth_map_.size()));
+    return depth_map_[depth];
+  }
 
   int get_depth() const { return depth_; }
   int get_vertices_num() const { return vertices_.size(); }
   int get_edges_num() const { return edges_.size(); }
 
-  std::vector<EdgeId> get_edge_ids_with_color(const Edge::Color& color) const;
+  // Kept up to date by `connect_vertices`, in the order edges were added.
+  const std::pmr::vector<EdgeId>& get_edge_ids_with_color(
+      const Edge::Color& color) const {
+    return edge_ids_by_color_[static_cast<int>(color)];
+  }
+  int get_edges_num(const Edge::Color& color) const {
+    return get_edge_ids_with_color(color).size();
+  }
+
+  // Every allocation of the graph so far, arena blocks or not.
+  const CountingMemoryResource& get_memory_counter() const {
+    return *memory_counter_;
+  }
 
  private:
-  std::vector<Vertex> vertices_;
-  std::vector<Edge> edges_;
+  // Declared first, so it outlives the containers allocating from it.
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+  // Sits between the containers and the arena or the default resource.
+  std::unique_ptr<CountingMemoryResource> memory_counter_;
+  std::pmr::vector<Vertex> vertices_;
+  std::pmr::vector<Edge> edges_;
+  std::array<std::pmr::vector<EdgeId>, Edge::COLORS_NUM> edge_ids_by_color_;
+  // Packed (min, max) vertex ids of every edge, see `connect_vertices`.
+  std::pmr::unordered_set<uint64_t> connected_pairs_;
+  // Vertex ids of every layer, kept in sync with `Vertex::depth`.
+  std::pmr::vector<std::pmr::vector<VertexId>> depth_map_;
   int depth_ = 0;
   VertexId vertex_id_counter_ = 0;
   EdgeId edge_id_counter_ = 0;
 
+  std::pmr::memory_resource* get_memory_resource() const {
+    return memory_counter_.get();
+  }
   VertexId get_next_vertex_id() { return vertex_id_counter_++; }
+  void set_vertex_depth(const VertexId& vertex_id, int depth);
   VertexId get_next_edge_id() { return edge_id_counter_++; }
 };
 
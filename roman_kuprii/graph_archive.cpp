@@ -0,0 +1,223 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "file_writer.hpp"
+#include "frozen_graph.hpp"
+#include "generation_stats.hpp"
+#include "graph_archive.hpp"
+#include "graph_generator.hpp"
+#include "graph_printing.hpp"
+
+namespace {
+
+constexpr std::string_view MAGIC = "GRAPHARC";
+constexpr size_t TRAILER_SIZE = 2 * sizeof(uint64_t) + MAGIC.size();
+
+using uni_cpp_practice::graph_archive::ENTRY_SIZE;
+using uni_cpp_practice::graph_archive::Entry;
+
+void append_uint64(std::string& bytes, uint64_t value) {
+  for (int byte = 0; byte < 8; byte++)
+    bytes.push_back(static_cast<char>(value >> (8 * byte)));
+}
+
+void append_int32(std::string& bytes, int value) {
+  const auto bits = static_cast<uint32_t>(value);
+  for (int byte = 0; byte < 4; byte++)
+    bytes.push_back(static_cast<char>(bits >> (8 * byte)));
+}
+
+uint64_t read_uint64(const char* bytes) {
+  uint64_t value = 0;
+  for (int byte = 0; byte < 8; byte++)
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[byte]))
+             << (8 * byte);
+  return value;
+}
+
+int read_int32(const char* bytes) {
+  uint32_t bits = 0;
+  for (int byte = 0; byte < 4; byte++)
+    bits |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[byte]))
+            << (8 * byte);
+  return static_cast<int>(bits);
+}
+
+void append_entry(std::string& bytes, const Entry& entry) {
+  append_uint64(bytes, entry.offset);
+  append_uint64(bytes, entry.length);
+  append_uint64(bytes, entry.seed);
+  append_int32(bytes, entry.graph_num);
+  append_int32(bytes, entry.depth);
+  append_int32(bytes, entry.new_vertices_num);
+  append_int32(bytes, entry.flags);
+}
+
+Entry read_entry(const char* bytes) {
+  Entry entry;
+  entry.offset = read_uint64(bytes);
+  entry.length = read_uint64(bytes + 8);
+  entry.seed = read_uint64(bytes + 16);
+  entry.graph_num = read_int32(bytes + 24);
+  entry.depth = read_int32(bytes + 28);
+  entry.new_vertices_num = read_int32(bytes + 32);
+  entry.flags = read_int32(bytes + 36);
+  return entry;
+}
+
+bool is_graph_num_less(const Entry& entry, int graph_num) {
+  return entry.graph_num < graph_num;
+}
+
+}  // namespace
+
+namespace uni_cpp_practice {
+
+namespace graph_archive {
+
+Writer::Writer(const std::string& file_path) : writer_(file_path) {
+  writer_.write(MAGIC);
+}
+
+void Writer::write_graph(const FrozenGraph& graph,
+                         int graph_num,
+                         const GraphGenerator::Params& params,
+                         GenerationStats* stats) {
+  const auto start = std::chrono::steady_clock::now();
+  const auto write_duration = writer_.get_write_duration();
+  Entry entry;
+  entry.offset = writer_.get_written_size();
+  graph_printing::print_graph_in_parallel(graph, writer_);
+  entry.length = writer_.get_written_size() - entry.offset;
+  if (stats != nullptr) {
+    // Buffered bytes are charged to whichever graph fills the buffer up.
+    const auto graph_write_duration =
+        writer_.get_write_duration() - write_duration;
+    stats->get_duration(GenerationStats::Phase::Write) += graph_write_duration;
+    stats->get_duration(GenerationStats::Phase::Serialize) +=
+        std::chrono::steady_clock::now() - start - graph_write_duration;
+  }
+  entry.seed = params.seed;
+  entry.graph_num = graph_num;
+  entry.depth = params.depth;
+  entry.new_vertices_num = params.new_vertices_num;
+  entry.flags = params.batch_sampling ? BATCH_SAMPLING_FLAG : 0;
+  entries_.push_back(entry);
+}
+
+void Writer::close() {
+  if (is_closed_)
+    return;
+  is_closed_ = true;
+
+  // Graphs arrive in the order they were finished.
+  std::sort(entries_.begin(), entries_.end(),
+            [](const Entry& first, const Entry& second) {
+              return first.graph_num < second.graph_num;
+            });
+  const uint64_t index_offset = writer_.get_written_size();
+  std::string index;
+  index.reserve(entries_.size() * ENTRY_SIZE + TRAILER_SIZE);
+  for (const auto& entry : entries_)
+    append_entry(index, entry);
+  append_uint64(index, index_offset);
+  append_uint64(index, entries_.size());
+  index += MAGIC;
+  writer_.write(index);
+  writer_.close();
+}
+
+Reader::Reader(const std::string& file_path)
+    : file_descriptor_(::open(file_path.c_str(), O_RDONLY)) {
+  if (file_descriptor_ == -1)
+    throw std::runtime_error("Failed to open " + file_path);
+  try {
+    read_index(file_path);
+  } catch (...) {
+    ::close(file_descriptor_);
+    throw;
+  }
+}
+
+void Reader::read_index(const std::string& file_path) {
+  const off_t file_size = ::lseek(file_descriptor_, 0, SEEK_END);
+  if (file_size < static_cast<off_t>(MAGIC.size() + TRAILER_SIZE))
+    throw std::runtime_error(file_path + " is not a graph archive");
+
+  std::array<char, TRAILER_SIZE> trailer;
+  read_exactly(trailer.data(), trailer.size(), file_size - TRAILER_SIZE);
+  const uint64_t index_offset = read_uint64(trailer.data());
+  const uint64_t graphs_num = read_uint64(trailer.data() + 8);
+  // Compared by division, a corrupted graphs number must not overflow into
+  // a matching index size.
+  const uint64_t index_end = file_size - TRAILER_SIZE;
+  if (std::string_view(trailer.data() + 16, MAGIC.size()) != MAGIC ||
+      index_offset < MAGIC.size() || index_offset > index_end ||
+      (index_end - index_offset) % ENTRY_SIZE != 0 ||
+      (index_end - index_offset) / ENTRY_SIZE != graphs_num)
+    throw std::runtime_error(file_path + " is not a graph archive");
+
+  std::string index(index_end - index_offset, '\0');
+  read_exactly(index.data(), index.size(), index_offset);
+  entries_.reserve(graphs_num);
+  for (uint64_t i = 0; i < graphs_num; i++) {
+    const auto entry = read_entry(index.data() + i * ENTRY_SIZE);
+    // Every graph lies between the leading magic and the index.
+    if (entry.offset < MAGIC.size() || entry.offset > index_offset ||
+        entry.length > index_offset - entry.offset)
+      throw std::runtime_error(file_path + ": graph " +
+                               std::to_string(entry.graph_num) +
+                               " is outside of the archive");
+    if (!entries_.empty() && entries_.back().graph_num >= entry.graph_num)
+      throw std::runtime_error(file_path +
+                               ": graph numbers are not sorted and unique");
+    entries_.push_back(entry);
+  }
+}
+
+const Entry& Reader::get_entry(int graph_num) const {
+  const auto entry = std::lower_bound(entries_.begin(), entries_.end(),
+                                      graph_num, is_graph_num_less);
+  if (entry == entries_.end() || entry->graph_num != graph_num)
+    throw std::out_of_range("No graph " + std::to_string(graph_num) +
+                            " in the archive");
+  return *entry;
+}
+
+std::string Reader::read_graph(int graph_num) const {
+  const auto& entry = get_entry(graph_num);
+  std::string graph_json(entry.length, '\0');
+  read_exactly(graph_json.data(), graph_json.size(), entry.offset);
+  return graph_json;
+}
+
+void Reader::read_exactly(char* data, size_t size, uint64_t offset) const {
+  while (size > 0) {
+    const ssize_t was_read = ::pread(file_descriptor_, data, size, offset);
+    if (was_read == -1 && errno == EINTR)
+      continue;
+    if (was_read <= 0)
+      throw std::runtime_error("Failed to read graph archive");
+    data += was_read;
+    size -= was_read;
+    offset += was_read;
+  }
+}
+
+Reader::~Reader() {
+  ::close(file_descriptor_);
+}
+
+}  // namespace graph_archive
+
+}  // namespace uni_cpp_practice
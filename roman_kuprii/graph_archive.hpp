@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "file_writer.hpp"
+#include "generation_stats.hpp"
+#include "graph_generator.hpp"
+
+namespace uni_cpp_practice {
+
+class FrozenGraph;
+
+// A batch of graphs in one file. The JSON of every graph is appended as it
+// is finished, an index footer then tells where each one is, so a batch is
+// written sequentially and any graph is read back without touching the
+// others. Layout, integers little endian:
+//
+//   "GRAPHARC"
+//   JSON of every graph, back to back, in the order they were written
+//   ENTRY_SIZE bytes per graph sorted by graph number: offset, length and
+//     seed as u64, graph number, depth, new_vertices_num and flags as i32
+//   index offset and graphs number as u64, then "GRAPHARC" again
+namespace graph_archive {
+
+constexpr size_t ENTRY_SIZE = 40;
+// Bit of `Entry::flags`, the graph was drawn with Params::batch_sampling.
+constexpr int BATCH_SAMPLING_FLAG = 1;
+
+struct Entry {
+  uint64_t offset = 0;
+  uint64_t length = 0;
+  // Params::seed of the batch, `GraphGenerator::generate(graph_num)` with
+  // the same params builds the same graph.
+  uint64_t seed = 0;
+  int graph_num = 0;
+  int depth = 0;
+  int new_vertices_num = 0;
+  int flags = 0;
+};
+
+class Writer {
+ public:
+  explicit Writer(const std::string& file_path);
+
+  // Adds the time spent printing and writing the graph to `stats` when it
+  // is given.
+  void write_graph(const FrozenGraph& graph,
+                   int graph_num,
+                   const GraphGenerator::Params& params,
+                   GenerationStats* stats = nullptr);
+
+  // Writes the index, without it the archive cannot be read.
+  void close();
+
+ private:
+  FileWriter writer_;
+  std::vector<Entry> entries_;
+  bool is_closed_ = false;
+};
+
+class Reader {
+ public:
+  explicit Reader(const std::string& file_path);
+
+  int get_graphs_num() const { return entries_.size(); }
+  // Sorted by graph number.
+  const std::vector<Entry>& get_entries() const { return entries_; }
+
+  // Throws std::out_of_range if the archive has no such graph.
+  const Entry& get_entry(int graph_num) const;
+  // JSON of the graph, read with a single positioned read.
+  std::string read_graph(int graph_num) const;
+
+  ~Reader();
+
+ private:
+  int file_descriptor_ = -1;
+  std::vector<Entry> entries_;
+
+  void read_index(const std::string& file_path);
+  void read_exactly(char* data, size_t size, uint64_t offset) const;
+
+  Reader(const Reader&) = delete;
+  Reader& operator=(const Reader&) = delete;
+};
+
+}  // namespace graph_archive
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,195 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "file_writer.hpp"
+#include "frozen_graph.hpp"
+#include "graph.hpp"
+#include "graph_binary.hpp"
+#include "mapped_file.hpp"
+
+namespace {
+
+using uni_cpp_practice::Edge;
+using uni_cpp_practice::graph_binary::EDGE_RECORD_SIZE;
+using uni_cpp_practice::graph_binary::Header;
+
+static_assert(sizeof(uni_cpp_practice::VertexId) == sizeof(int32_t) &&
+              sizeof(uni_cpp_practice::EdgeId) == sizeof(int32_t));
+
+constexpr std::array<char, 8> MAGIC = {'G', 'R', 'A', 'P', 'H', 'B', 'I', 'N'};
+constexpr size_t SECTION_ALIGNMENT = 8;
+
+enum Section {
+  VERTICES_NUM_AT_DEPTH,
+  VERTEX_DEPTHS,
+  EDGE_OFFSETS,
+  EDGE_IDS,
+  NEIGHBOUR_IDS,
+  EDGES,
+  SECTIONS_NUM
+};
+
+size_t align_section(size_t offset) {
+  return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT *
+         SECTION_ALIGNMENT;
+}
+
+// Offsets of every section, and of the end of the file, as the counts in
+// `header` lay them out.
+std::array<uint64_t, SECTIONS_NUM + 1> get_section_offsets(
+    const Header& header) {
+  const std::array<uint64_t, SECTIONS_NUM> sizes = {
+      (static_cast<uint64_t>(header.depth) + 1) * sizeof(int32_t),
+      static_cast<uint64_t>(header.vertices_num) * sizeof(int32_t),
+      (static_cast<uint64_t>(header.vertices_num) + 1) * sizeof(int32_t),
+      static_cast<uint64_t>(header.adjacency_size) * sizeof(int32_t),
+      static_cast<uint64_t>(header.adjacency_size) * sizeof(int32_t),
+      static_cast<uint64_t>(header.edges_num) * EDGE_RECORD_SIZE};
+  std::array<uint64_t, SECTIONS_NUM + 1> offsets;
+  uint64_t offset = sizeof(Header);
+  for (int section = 0; section < SECTIONS_NUM; section++) {
+    offsets[section] = align_section(offset);
+    offset = offsets[section] + sizes[section];
+  }
+  offsets[SECTIONS_NUM] = offset;
+  return offsets;
+}
+
+void write_bytes(uni_cpp_practice::FileWriter& writer,
+                 const void* data,
+                 size_t size) {
+  writer.write(std::string_view(static_cast<const char*>(data), size));
+}
+
+void write_padding(uni_cpp_practice::FileWriter& writer, uint64_t offset) {
+  constexpr std::array<char, SECTION_ALIGNMENT> zeros = {};
+  write_bytes(writer, zeros.data(), offset - writer.get_written_size());
+}
+
+void write_int32(uni_cpp_practice::FileWriter& writer, int32_t value) {
+  write_bytes(writer, &value, sizeof(value));
+}
+
+template <typename T>
+void write_row(uni_cpp_practice::FileWriter& writer,
+               const uni_cpp_practice::ConstSpan<T>& row) {
+  write_bytes(writer, row.begin(), row.size() * sizeof(T));
+}
+
+}  // namespace
+
+namespace uni_cpp_practice {
+
+namespace graph_binary {
+
+void write_graph(const FrozenGraph& graph, const std::string& file_path) {
+  Header header = {};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.byte_order = BYTE_ORDER_MARK;
+  header.depth = graph.get_depth();
+  header.vertices_num = graph.get_vertices_num();
+  header.edges_num = graph.get_edges_num();
+  for (int color = 0; color < Edge::COLORS_NUM; color++)
+    header.edges_num_by_color[color] =
+        graph.get_edges_num(static_cast<Edge::Color>(color));
+  for (VertexId vertex_id = 0; vertex_id < graph.get_vertices_num();
+       vertex_id++)
+    header.adjacency_size += graph.get_edge_ids(vertex_id).size();
+  const auto offsets = get_section_offsets(header);
+  header.file_size = offsets[SECTIONS_NUM];
+
+  FileWriter writer(file_path);
+  write_bytes(writer, &header, sizeof(header));
+
+  write_padding(writer, offsets[VERTICES_NUM_AT_DEPTH]);
+  for (int depth = 0; depth <= graph.get_depth(); depth++)
+    write_int32(writer, graph.get_vertices_num_at_depth(depth));
+
+  write_padding(writer, offsets[VERTEX_DEPTHS]);
+  for (VertexId vertex_id = 0; vertex_id < graph.get_vertices_num();
+       vertex_id++)
+    write_int32(writer, graph.get_vertex_depth(vertex_id));
+
+  write_padding(writer, offsets[EDGE_OFFSETS]);
+  int32_t edge_offset = 0;
+  write_int32(writer, edge_offset);
+  for (VertexId vertex_id = 0; vertex_id < graph.get_vertices_num();
+       vertex_id++) {
+    edge_offset += graph.get_edge_ids(vertex_id).size();
+    write_int32(writer, edge_offset);
+  }
+
+  write_padding(writer, offsets[EDGE_IDS]);
+  for (VertexId vertex_id = 0; vertex_id < graph.get_vertices_num();
+       vertex_id++)
+    write_row(writer, graph.get_edge_ids(vertex_id));
+
+  write_padding(writer, offsets[NEIGHBOUR_IDS]);
+  for (VertexId vertex_id = 0; vertex_id < graph.get_vertices_num();
+       vertex_id++)
+    write_row(writer, graph.get_neighbour_ids(vertex_id));
+
+  write_padding(writer, offsets[EDGES]);
+  std::array<char, EDGE_RECORD_SIZE> record;
+  for (EdgeId edge_id = 0; edge_id < graph.get_edges_num(); edge_id++) {
+    const auto& vertices = graph.get_edge_vertices(edge_id);
+    std::memcpy(record.data(), vertices.data(), sizeof(vertices));
+    record.back() = static_cast<char>(graph.get_edge_color(edge_id));
+    write_bytes(writer, record.data(), record.size());
+  }
+  writer.close();
+}
+
+MappedGraph::MappedGraph(const std::string& file_path) : file_(file_path) {
+  map_sections(file_path);
+}
+
+void MappedGraph::map_sections(const std::string& file_path) {
+  if (file_.get_size() < sizeof(Header))
+    throw std::runtime_error(file_path + " is not a binary graph");
+  const char* const data = file_.get_data();
+  header_ = reinterpret_cast<const Header*>(data);
+  if (header_->magic != MAGIC)
+    throw std::runtime_error(file_path + " is not a binary graph");
+  if (header_->version != VERSION)
+    throw std::runtime_error(file_path + " has binary graph version " +
+                             std::to_string(header_->version));
+  if (header_->byte_order != BYTE_ORDER_MARK)
+    throw std::runtime_error(file_path + " has a foreign byte order");
+
+  if (header_->depth < 0 || header_->vertices_num < 0 ||
+      header_->edges_num < 0 || header_->adjacency_size < 0)
+    throw std::runtime_error(file_path + " is truncated or corrupted");
+  const auto offsets = get_section_offsets(*header_);
+  if (header_->file_size != offsets[SECTIONS_NUM] ||
+      file_.get_size() != offsets[SECTIONS_NUM])
+    throw std::runtime_error(file_path + " is truncated or corrupted");
+
+  const auto get_column = [data, &offsets](Section section) {
+    return reinterpret_cast<const int32_t*>(data + offsets[section]);
+  };
+  vertices_num_at_depth_ = get_column(VERTICES_NUM_AT_DEPTH);
+  vertex_depths_ = get_column(VERTEX_DEPTHS);
+  edge_offsets_ = get_column(EDGE_OFFSETS);
+  edge_ids_ = get_column(EDGE_IDS);
+  neighbour_ids_ = get_column(NEIGHBOUR_IDS);
+  edges_ = data + offsets[EDGES];
+
+  // Rows are handed out as spans, so every one of them must lie inside its
+  // column. This reads the offsets column up front, the others stay lazy.
+  if (edge_offsets_[0] != 0 ||
+      edge_offsets_[header_->vertices_num] != header_->adjacency_size)
+    throw std::runtime_error(file_path + " has corrupted edge offsets");
+  for (VertexId vertex_id = 0; vertex_id < header_->vertices_num; vertex_id++)
+    if (edge_offsets_[vertex_id] > edge_offsets_[vertex_id + 1])
+      throw std::runtime_error(file_path + " has corrupted edge offsets");
+}
+
+}  // namespace graph_binary
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "frozen_graph.hpp"
+#include "graph.hpp"
+#include "mapped_file.hpp"
+
+namespace uni_cpp_practice {
+
+// Binary form of a FrozenGraph, laid out so it can be used straight from a
+// memory mapping. A Header is followed by these sections, each starting at
+// a multiple of 8 bytes:
+//
+//   vertices_num_at_depth  int32[depth + 1]
+//   vertex_depths          int32[vertices_num]
+//   edge_offsets           int32[vertices_num + 1]   CSR rows of the two
+//   edge_ids               int32[adjacency_size]     columns below, see
+//   neighbour_ids          int32[adjacency_size]     FrozenGraph
+//   edges                  EDGE_RECORD_SIZE bytes per edge: both vertex ids
+//                          as int32 and the color as one byte
+//
+// Integers are in the byte order of the machine that wrote the file,
+// `Header::byte_order` lets a reader refuse a foreign one.
+namespace graph_binary {
+
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr size_t EDGE_RECORD_SIZE = 2 * sizeof(int32_t) + 1;
+
+struct Header {
+  std::array<char, 8> magic;
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t file_size;
+  int32_t depth;
+  int32_t vertices_num;
+  int32_t edges_num;
+  int32_t adjacency_size;
+  std::array<int32_t, Edge::COLORS_NUM> edges_num_by_color;
+  int32_t reserved;
+};
+static_assert(sizeof(Header) == 64);
+
+void write_graph(const FrozenGraph& graph, const std::string& file_path);
+
+// Read-only graph over a mapped file, with the accessors of FrozenGraph.
+// Opening checks the header against the file size and reads the edge
+// offsets, the other pages are read on first use.
+class MappedGraph {
+ public:
+  // Throws std::runtime_error if the file is not a graph of this version,
+  // or if its sections do not fit in it.
+  explicit MappedGraph(const std::string& file_path);
+
+  int get_depth() const { return header_->depth; }
+  int get_vertices_num() const { return header_->vertices_num; }
+  int get_edges_num() const { return header_->edges_num; }
+  int get_edges_num(const Edge::Color& color) const {
+    return header_->edges_num_by_color[static_cast<int>(color)];
+  }
+  int get_vertices_num_at_depth(int depth) const {
+    assert(depth >= 0 && depth <= get_depth());
+    return vertices_num_at_depth_[depth];
+  }
+
+  int get_vertex_depth(const VertexId& vertex_id) const {
+    return vertex_depths_[vertex_id];
+  }
+  ConstSpan<EdgeId> get_edge_ids(const VertexId& vertex_id) const {
+    return get_row(edge_ids_, vertex_id);
+  }
+  ConstSpan<VertexId> get_neighbour_ids(const VertexId& vertex_id) const {
+    return get_row(neighbour_ids_, vertex_id);
+  }
+
+  // Records are packed, so these are copied out rather than referenced.
+  std::array<VertexId, 2> get_edge_vertices(const EdgeId& edge_id) const {
+    std::array<VertexId, 2> vertices;
+    std::memcpy(vertices.data(), get_edge_record(edge_id),
+                sizeof(vertices));
+    return vertices;
+  }
+  Edge::Color get_edge_color(const EdgeId& edge_id) const {
+    return static_cast<Edge::Color>(
+        get_edge_record(edge_id)[EDGE_RECORD_SIZE - 1]);
+  }
+
+ private:
+  MappedFile file_;
+  const Header* header_ = nullptr;
+  const int32_t* vertices_num_at_depth_ = nullptr;
+  const int32_t* vertex_depths_ = nullptr;
+  const int32_t* edge_offsets_ = nullptr;
+  const int32_t* edge_ids_ = nullptr;
+  const int32_t* neighbour_ids_ = nullptr;
+  const char* edges_ = nullptr;
+
+  void map_sections(const std::string& file_path);
+
+  ConstSpan<int32_t> get_row(const int32_t* column,
+                             const VertexId& vertex_id) const {
+    assert(vertex_id >= 0 && vertex_id < get_vertices_num());
+    const int begin = edge_offsets_[vertex_id];
+    return ConstSpan<int32_t>(column + begin,
+                              edge_offsets_[vertex_id + 1] - begin);
+  }
+  const char* get_edge_record(const EdgeId& edge_id) const {
+    assert(edge_id >= 0 && edge_id < get_edges_num());
+    return edges_ + static_cast<size_t>(edge_id) * EDGE_RECORD_SIZE;
+  }
+
+  MappedGraph(const MappedGraph&) = delete;
+  MappedGraph& operator=(const MappedGraph&) = delete;
+};
+
+}  // namespace graph_binary
+
+}  // namespace uni_cpp_practice
@@ -1,14 +1,12 @@
+#include <condition_variable>
 #include <functional>
-#include <list>
 #include <mutex>
-#include <optional>
-#include <random>
-#include <thread>
-#include <vector>
 
+#include "generation_stats.hpp"
 #include "graph.hpp"
 #include "graph_generation_controller.hpp"
 #include "graph_generator.hpp"
+#include "thread_pool.hpp"
 
 namespace uni_cpp_practice {
 
@@ -18,90 +16,51 @@ GraphGenerationController::GraphGenerationController(
     int threads_count,
     int graphs_count,
     const GraphGenerator::Params& graph_generator_params)
-    : graphs_count_(graphs_count), graph_generator_(graph_generator_params) {
-  for (int iter = 0; iter < threads_count; iter++) {
-    workers_.emplace_back(
-        [&jobs_ = jobs_,
-         &get_job_mutex_ = get_job_mutex_]() -> std::optional<JobCallback> {
-          const std::lock_guard lock(get_job_mutex_);
-          if (jobs_.empty()) {
-            return std::nullopt;
-          }
-          const auto job = jobs_.front();
-          jobs_.pop_front();
-          return job;
-        });
-  }
-}
+    : threads_count_(threads_count),
+      graphs_count_(graphs_count),
+      graph_generator_(graph_generator_params) {}
 
 void GraphGenerationController::generate(
     const GenStartedCallback& gen_started_callback,
     const GenFinishedCallback& gen_finished_callback) {
-  std::atomic<int> completed_jobs = 0;
-
-  for (auto& worker : workers_) {
-    worker.start();
-  }
+  // Graphs run on the process-wide pool, which their generators share for
+  // the branch and color jobs. `threads_count_` bounds how many graphs are
+  // in flight at once.
+  TaskGroup graph_jobs;
+  std::mutex in_flight_mutex;
+  std::condition_variable in_flight_cv;
+  int in_flight_jobs = 0;
 
-  {
-    std::lock_guard lock(get_job_mutex_);
-    for (int i = 0; i < graphs_count_; i++) {
-      jobs_.emplace_back([&gen_started_callback = gen_started_callback,
-                          &gen_finished_callback = gen_finished_callback, i,
-                          &finish_callback_mutex_ = finish_callback_mutex_,
-                          &start_callback_mutex_ = start_callback_mutex_,
-                          &graph_generator_ = graph_generator_,
-                          &completed_jobs = completed_jobs]() {
-        {
-          const std::lock_guard lock(start_callback_mutex_);
-          gen_started_callback(i);
-        }
-
-        auto graph = graph_generator_.generate();
-        {
-          const std::lock_guard lock(finish_callback_mutex_);
-          gen_finished_callback(std::move(graph), i);
-        }
-        completed_jobs++;
+  for (int i = 0; i < graphs_count_; i++) {
+    {
+      std::unique_lock lock(in_flight_mutex);
+      in_flight_cv.wait(lock, [this, &in_flight_jobs]() {
+        return in_flight_jobs < threads_count_;
       });
+      in_flight_jobs++;
     }
-  }
-  while (completed_jobs != graphs_count_) {
-  }
+    graph_jobs.run([&gen_started_callback = gen_started_callback,
+                    &gen_finished_callback = gen_finished_callback, i,
+                    &start_callback_mutex_ = start_callback_mutex_,
+                    &graph_generator_ = graph_generator_, &in_flight_mutex,
+                    &in_flight_cv, &in_flight_jobs]() {
+      {
+        const std::lock_guard lock(start_callback_mutex_);
+        gen_started_callback(i);
+      }
 
-  for (auto& worker : workers_) {
-    worker.stop();
+      GenerationStats stats;
+      auto graph = graph_generator_.generate(i, &stats);
+      gen_finished_callback(std::move(graph), i, stats);
+      {
+        const std::lock_guard lock(in_flight_mutex);
+        in_flight_jobs--;
+      }
+      in_flight_cv.notify_one();
+    });
   }
-}
-
-GraphGenerationController::Worker::~Worker() {
-  if (state_ == State::Working)
-    stop();
-}
-
-void GraphGenerationController::Worker::start() {
-  assert(state_ != State::Working);
-  state_ = State::Working;
-  thread_ =
-      std::thread([&state_ = state_, &get_job_callback_ = get_job_callback_]() {
-        while (true) {
-          if (state_ == State::ShouldTerminate) {
-            state_ = State::Idle;
-            return;
-          }
-          const auto job_optional = get_job_callback_();
-          if (job_optional.has_value()) {
-            job_optional.value()();
-          }
-        }
-      });
-}
 
-void GraphGenerationController::Worker::stop() {
-  assert(state_ == State::Working);
-  state_ = State::ShouldTerminate;
-  if (thread_.joinable())
-    thread_.join();
+  graph_jobs.wait();
 }
 
 }  // namespace graph_generation_controller
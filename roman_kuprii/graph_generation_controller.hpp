@@ -1,12 +1,9 @@
 #pragma once
 
-#include <atomic>
 #include <functional>
-#include <list>
 #include <mutex>
-#include <optional>
-#include <thread>
 
+#include "generation_stats.hpp"
 #include "graph_generator.hpp"
 
 namespace uni_cpp_practice {
@@ -17,45 +14,26 @@ namespace graph_generation_controller {
 
 class GraphGenerationController {
  public:
-  using JobCallback = std::function<void()>;
-  using GetJobCallback = std::function<std::optional<JobCallback>()>;
   using GenStartedCallback = std::function<void(int)>;
-  using GenFinishedCallback = std::function<void(Graph, int)>;
-
-  class Worker {
-   public:
-    explicit Worker(const GetJobCallback& get_job_callback)
-        : get_job_callback_(get_job_callback){};
-
-    enum class State { Idle, Working, ShouldTerminate };
-
-    void start();
-    void stop();
-
-    ~Worker();
-
-   private:
-    std::thread thread_;
-    GetJobCallback get_job_callback_;
-    std::atomic<State> state_ = State::Idle;
-  };
+  using GenFinishedCallback =
+      std::function<void(Graph, int, const GenerationStats&)>;
 
   GraphGenerationController(
       int threads_count,
       int graphs_count,
       const GraphGenerator::Params& graph_generator_params);
 
+  // `gen_finished_callback` is called from the job that generated the
+  // graph, concurrently with other finished graphs, so it must be thread
+  // safe. Its work then runs in parallel instead of behind one lock.
   void generate(const GenStartedCallback& gen_started_callback,
                 const GenFinishedCallback& gen_finished_callback);
 
  private:
-  std::list<Worker> workers_;
-  std::list<JobCallback> jobs_;
+  int threads_count_;
   int graphs_count_;
   GraphGenerator graph_generator_;
   std::mutex start_callback_mutex_;
-  std::mutex finish_callback_mutex_;
-  std::mutex get_job_mutex_;
 };
 
 }  // namespace graph_generation_controller
@@ -1,250 +1,528 @@
-#include <atomic>
-#include <functional>
-#include <list>
-#include <mutex>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory_resource>
 #include <optional>
-#include <random>
-#include <thread>
+#include <utility>
 #include <vector>
 
+#include "bernoulli_mask.hpp"
+#include "generation_stats.hpp"
 #include "graph.hpp"
 #include "graph_generator.hpp"
+#include "random_engine.hpp"
+#include "thread_pool.hpp"
 
 namespace {
 
+// Draws made on this thread, a slice job reads how many it took.
+thread_local uint64_t thread_random_draws_num = 0;
+
 double get_real_random_number() {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_real_distribution<> dis(0, 1);
-  return dis(gen);
+  thread_random_draws_num++;
+  return uni_cpp_practice::random_engine::get_thread_engine().get_real();
 }
 
 int get_int_random_number(int upper_bound) {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_int_distribution<> dis(0, upper_bound);
-  return dis(gen);
+  thread_random_draws_num++;
+  return uni_cpp_practice::random_engine::get_thread_engine().get_int(
+      upper_bound);
+}
+
+// Failed trials before the next success of Bernoulli trials with
+// `log(1 - probability) == log_failure`, geometrically distributed.
+size_t get_geometric_random_number(double log_failure) {
+  return static_cast<size_t>(std::log1p(-get_real_random_number()) /
+                             log_failure);
+}
+
+// Substreams of one graph seed: one per color pass, split further per layer
+// slice, and one for the gray tree, split per layer, so a graph does not
+// depend on which thread ran which part of it.
+constexpr uint64_t GREEN_STREAM = 0;
+constexpr uint64_t BLUE_STREAM = 1;
+constexpr uint64_t YELLOW_STREAM = 2;
+constexpr uint64_t RED_STREAM = 3;
+constexpr uint64_t GRAY_STREAM = 4;
+
+void seed_thread_engine(uint64_t graph_seed, uint64_t stream) {
+  uni_cpp_practice::random_engine::get_thread_engine().reseed(graph_seed,
+                                                              stream);
 }
 
 constexpr double GREEN_TRASHOULD = 0.1;
 constexpr double BLUE_TRASHOULD = 0.25;
 constexpr double RED_TRASHOULD = 0.33;
 
-constexpr int MAX_THREADS_COUNT = 4;
+constexpr int YELLOW_PICK_ATTEMPTS = 4;
+
+// Filling a mask costs about a nanosecond per trial whatever the
+// probability, drawing a geometric gap some 25 per success, so gaps only
+// pay off for the sparsest trials.
+constexpr double MAX_SKIP_SAMPLING_PROBABILITY = 0.04;
+
+// Standard deviations above the mean reserved for, about the 99th
+// percentile of a normal distribution.
+constexpr double SIZE_QUANTILE_SIGMAS = 2.33;
 
 using std::vector;
 
 using uni_cpp_practice::Edge;
 using uni_cpp_practice::Graph;
+using Params = uni_cpp_practice::GraphGenerator::Params;
 using uni_cpp_practice::INVALID_ID;
-using uni_cpp_practice::Vertex;
 using uni_cpp_practice::VertexId;
 
-void add_blue_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
-  const int graph_depth = work_graph.get_depth();
-  for (int current_depth = 1; current_depth <= graph_depth; current_depth++) {
-    vector<Vertex> uni_depth_vertices;
-    for (const auto& vertex : work_graph.get_vertices())
-      if (vertex.depth == current_depth)
-        uni_depth_vertices.emplace_back(vertex);
-
-    std::array<VertexId, 2> adjacent_vertices = {INVALID_ID, INVALID_ID};
-    for (const auto& vertex : uni_depth_vertices) {
-      if (adjacent_vertices[0] == INVALID_ID) {
-        adjacent_vertices[0] = vertex.get_id();
-      } else if (adjacent_vertices[1] == INVALID_ID) {
-        adjacent_vertices[1] = vertex.get_id();
-        if (get_real_random_number() < BLUE_TRASHOULD) {
-          std::lock_guard lock(add_edge_mutex);
-          work_graph.connect_vertices(adjacent_vertices[0],
-                                      adjacent_vertices[1], false);
-        }
-      } else {
-        adjacent_vertices[0] = adjacent_vertices[1];
-        adjacent_vertices[1] = vertex.get_id();
-        if (get_real_random_number() < BLUE_TRASHOULD) {
-          std::lock_guard lock(add_edge_mutex);
-          work_graph.connect_vertices(adjacent_vertices[0],
-                                      adjacent_vertices[1], false);
-        }
-      }
-    }
+// Layers are cut into slices of this many start vertices, every slice is
+// one pool job. The slicing depends only on the graph, so the edges do not
+// depend on the number of workers either.
+constexpr size_t COLOR_SLICE_SIZE = 4096;
+// Parents per job when the gray tree grows a layer.
+constexpr size_t GRAY_SLICE_SIZE = 1024;
+
+// Runs `job(i)` for every slice index, as pool jobs or in order on the
+// calling thread.
+template <typename Job>
+void run_slice_jobs(size_t slices_num, bool in_parallel, const Job& job) {
+  if (!in_parallel || slices_num == 1) {
+    for (size_t i = 0; i < slices_num; i++)
+      job(i);
+    return;
   }
+  uni_cpp_practice::TaskGroup slice_jobs;
+  for (size_t i = 0; i < slices_num; i++)
+    slice_jobs.run([&job, i]() { job(i); });
+  slice_jobs.wait();
 }
 
-void add_green_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
-  for (const auto& start_vertex : work_graph.get_vertices())
-    if (get_real_random_number() < GREEN_TRASHOULD) {
-      std::lock_guard lock(add_edge_mutex);
-      work_graph.connect_vertices(start_vertex.get_id(), start_vertex.get_id(),
-                                  false);
-    }
+using EdgeCandidates = vector<std::pair<VertexId, VertexId>>;
+
+// Start vertices `[begin, end)` of layer `depth` for one color pass. The
+// slice draws from substream `index` of the color stream.
+struct ColorSlice {
+  Edge::Color color;
+  uint64_t stream;
+  uint64_t index;
+  int depth;
+  size_t begin;
+  size_t end;
+  bool batch_sampling;
+};
+
+// Calls `on_success(i)` for every `i` in `[first, slice.end)` whose
+// Bernoulli trial succeeds. Batch sampling draws the same distribution
+// either as geometric gaps between successes, one draw per success, or as
+// a mask of the whole range, rather than one engine draw per vertex.
+template <typename OnSuccess>
+void for_each_success(const ColorSlice& slice,
+                      size_t first,
+                      double probability,
+                      const OnSuccess& on_success) {
+  if (!slice.batch_sampling) {
+    for (size_t i = first; i < slice.end; i++)
+      if (get_real_random_number() < probability)
+        on_success(i);
+    return;
+  }
+  if (probability <= 0 || first >= slice.end)
+    return;
+
+  if (probability < MAX_SKIP_SAMPLING_PROBABILITY) {
+    const double log_failure = std::log1p(-probability);
+    for (size_t i = first + get_geometric_random_number(log_failure);
+         i < slice.end; i += 1 + get_geometric_random_number(log_failure))
+      on_success(i);
+    return;
+  }
+
+  namespace bernoulli_mask = uni_cpp_practice::bernoulli_mask;
+  bernoulli_mask::Mask mask;
+  // The key and a hashed value per trial.
+  thread_random_draws_num += 1 + (slice.end - first);
+  bernoulli_mask::fill(
+      mask, slice.end - first, probability,
+      uni_cpp_practice::random_engine::get_thread_engine()());
+  bernoulli_mask::for_each_success(
+      mask, [first, &on_success](size_t i) { on_success(first + i); });
 }
 
-void add_red_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
-  const int graph_depth = work_graph.get_depth();
-  for (const auto& start_vertex : work_graph.get_vertices()) {
-    if (get_real_random_number() < RED_TRASHOULD) {
-      if (start_vertex.depth + 2 <= graph_depth) {
-        vector<VertexId> red_vertices_ids;
-        for (const auto& end_vertex : work_graph.get_vertices()) {
-          if (end_vertex.depth == start_vertex.depth + 2)
-            red_vertices_ids.emplace_back(end_vertex.get_id());
-        }
-        if (red_vertices_ids.size() > 0) {
-          std::lock_guard lock(add_edge_mutex);
-          work_graph.connect_vertices(start_vertex.get_id(),
-                                      red_vertices_ids[get_int_random_number(
-                                          red_vertices_ids.size() - 1)],
-                                      false);
-        }
-      }
-    }
+void add_green_candidates(const Graph& work_graph,
+                          const ColorSlice& slice,
+                          EdgeCandidates& candidates) {
+  const auto& layer = work_graph.get_vertices_at_depth(slice.depth);
+  for_each_success(slice, slice.begin, GREEN_TRASHOULD,
+                   [&layer, &candidates](size_t i) {
+                     candidates.emplace_back(layer[i], layer[i]);
+                   });
+}
+
+void add_blue_candidates(const Graph& work_graph,
+                         const ColorSlice& slice,
+                         EdgeCandidates& candidates) {
+  const auto& layer = work_graph.get_vertices_at_depth(slice.depth);
+  for_each_success(slice, std::max<size_t>(slice.begin, 1), BLUE_TRASHOULD,
+                   [&layer, &candidates](size_t i) {
+                     candidates.emplace_back(layer[i - 1], layer[i]);
+                   });
+}
+
+void add_red_candidates(const Graph& work_graph,
+                        const ColorSlice& slice,
+                        EdgeCandidates& candidates) {
+  const auto& layer = work_graph.get_vertices_at_depth(slice.depth);
+  const auto& red_vertices_ids =
+      work_graph.get_vertices_at_depth(slice.depth + 2);
+  for_each_success(
+      slice, slice.begin, RED_TRASHOULD,
+      [&layer, &red_vertices_ids, &candidates](size_t i) {
+        candidates.emplace_back(
+            layer[i], red_vertices_ids[get_int_random_number(
+                          red_vertices_ids.size() - 1)]);
+      });
+}
+
+// Picks a uniformly random vertex of `next_layer` not yet connected to
+// `start_vertex_id`. A few blind draws almost always succeed since a vertex
+// has only a handful of edges, the full scan is a fallback for tiny layers.
+VertexId pick_yellow_vertex(const Graph& work_graph,
+                            const VertexId& start_vertex_id,
+                            const std::pmr::vector<VertexId>& next_layer) {
+  for (int attempt = 0; attempt < YELLOW_PICK_ATTEMPTS; attempt++) {
+    const VertexId candidate_id =
+        next_layer[get_int_random_number(next_layer.size() - 1)];
+    if (!work_graph.is_connected(start_vertex_id, candidate_id))
+      return candidate_id;
   }
+
+  vector<VertexId> yellow_vertices_ids;
+  for (const auto& end_vertex_id : next_layer)
+    if (!work_graph.is_connected(start_vertex_id, end_vertex_id))
+      yellow_vertices_ids.push_back(end_vertex_id);
+  if (yellow_vertices_ids.empty())
+    return INVALID_ID;
+  return yellow_vertices_ids[get_int_random_number(yellow_vertices_ids.size() -
+                                                   1)];
 }
 
-void add_yellow_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
-  const int graph_depth = work_graph.get_depth();
-  for (const auto& start_vertex : work_graph.get_vertices()) {
-    const double probability = static_cast<double>(start_vertex.depth) /
-                               static_cast<double>(graph_depth);
-    if (get_real_random_number() < probability) {
-      vector<VertexId> yellow_vertices_ids;
-      for (const auto& end_vertex : work_graph.get_vertices()) {
-        if (end_vertex.depth == start_vertex.depth + 1) {
-          const auto is_connected = [&work_graph, &add_edge_mutex,
-                                     &start_vertex, &end_vertex]() {
-            const std::lock_guard lock(add_edge_mutex);
-            return work_graph.is_connected(start_vertex.get_id(),
-                                           end_vertex.get_id());
-          }();
-          if (!is_connected)
-            yellow_vertices_ids.push_back(end_vertex.get_id());
-        }
-      }
-      if (yellow_vertices_ids.size() > 0) {
-        std::lock_guard lock(add_edge_mutex);
-        work_graph.connect_vertices(start_vertex.get_id(),
-                                    yellow_vertices_ids[get_int_random_number(
-                                        yellow_vertices_ids.size() - 1)],
-                                    false);
-      }
-    }
+// Slices only read the graph, nothing is written to it before the merge. At
+// that point only gray edges join neighbouring layers, which is all the
+// yellow pass has to avoid.
+void add_yellow_candidates(const Graph& work_graph,
+                           const ColorSlice& slice,
+                           EdgeCandidates& candidates) {
+  const auto& layer = work_graph.get_vertices_at_depth(slice.depth);
+  const auto& next_layer = work_graph.get_vertices_at_depth(slice.depth + 1);
+  const double probability = static_cast<double>(slice.depth) /
+                             static_cast<double>(work_graph.get_depth());
+  for_each_success(slice, slice.begin, probability,
+                   [&work_graph, &layer, &next_layer, &candidates](size_t i) {
+                     const VertexId end_vertex_id =
+                         pick_yellow_vertex(work_graph, layer[i], next_layer);
+                     if (end_vertex_id != INVALID_ID)
+                       candidates.emplace_back(layer[i], end_vertex_id);
+                   });
+}
+
+void add_color_candidates(const Graph& work_graph,
+                          const ColorSlice& slice,
+                          EdgeCandidates& candidates) {
+  switch (slice.color) {
+    case Edge::Color::Green:
+      return add_green_candidates(work_graph, slice, candidates);
+    case Edge::Color::Blue:
+      return add_blue_candidates(work_graph, slice, candidates);
+    case Edge::Color::Yellow:
+      return add_yellow_candidates(work_graph, slice, candidates);
+    case Edge::Color::Red:
+      return add_red_candidates(work_graph, slice, candidates);
+    case Edge::Color::Gray:
+      return;
+  }
+}
+
+// Cuts layers `[first_depth, last_depth]` into slices of one color pass.
+void add_color_slices(vector<ColorSlice>& slices,
+                      const Graph& work_graph,
+                      const Edge::Color& color,
+                      uint64_t stream,
+                      int first_depth,
+                      int last_depth,
+                      bool batch_sampling) {
+  uint64_t index = 0;
+  for (int depth = first_depth; depth <= last_depth; depth++) {
+    const size_t layer_size = work_graph.get_vertices_at_depth(depth).size();
+    for (size_t begin = 0; begin < layer_size; begin += COLOR_SLICE_SIZE)
+      slices.push_back({color, stream, index++, depth, begin,
+                        std::min(begin + COLOR_SLICE_SIZE, layer_size),
+                        batch_sampling});
   }
 }
 
-void paint_edges(Graph& work_graph) {
-  std::mutex add_edges_mutex;
-  std::thread blue_thread([&work_graph, &add_edges_mutex]() {
-    add_blue_edges(work_graph, add_edges_mutex);
-  });
-  std::thread green_thread([&work_graph, &add_edges_mutex]() {
-    add_green_edges(work_graph, add_edges_mutex);
-  });
-  std::thread red_thread([&work_graph, &add_edges_mutex]() {
-    add_red_edges(work_graph, add_edges_mutex);
-  });
-  std::thread yellow_thread([&work_graph, &add_edges_mutex]() {
-    add_yellow_edges(work_graph, add_edges_mutex);
-  });
-  blue_thread.join();
-  green_thread.join();
-  red_thread.join();
-  yellow_thread.join();
+// Slices of every color pass, or of the `only_color` one.
+vector<ColorSlice> get_color_slices(
+    const Graph& work_graph,
+    bool batch_sampling,
+    const std::optional<Edge::Color>& only_color) {
+  const int graph_depth = work_graph.get_depth();
+  vector<ColorSlice> slices;
+  const auto add_pass = [&slices, &work_graph, batch_sampling, &only_color](
+                            const Edge::Color& color, uint64_t stream,
+                            int first_depth, int last_depth) {
+    if (!only_color.has_value() || *only_color == color)
+      add_color_slices(slices, work_graph, color, stream, first_depth,
+                       last_depth, batch_sampling);
+  };
+  add_pass(Edge::Color::Green, GREEN_STREAM, 0, graph_depth);
+  add_pass(Edge::Color::Blue, BLUE_STREAM, 1, graph_depth);
+  add_pass(Edge::Color::Yellow, YELLOW_STREAM, 1, graph_depth - 1);
+  add_pass(Edge::Color::Red, RED_STREAM, 0, graph_depth - 2);
+  return slices;
+}
+
+// What one slice job took, summed up per color once all have run.
+struct SliceCost {
+  std::chrono::nanoseconds duration = {};
+  uint64_t random_draws_num = 0;
+};
+
+// Every slice draws from its own substream and fills its own buffer without
+// locking, then the buffers are merged in slice order. The merge is the only
+// place the graph is written, it also drops the pairs that are already
+// connected.
+void paint_color_edges(Graph& work_graph,
+                       uint64_t graph_seed,
+                       bool in_parallel,
+                       bool batch_sampling,
+                       const std::optional<Edge::Color>& only_color,
+                       uni_cpp_practice::GenerationStats* stats) {
+  using Phase = uni_cpp_practice::GenerationStats::Phase;
+
+  const vector<ColorSlice> slices =
+      get_color_slices(work_graph, batch_sampling, only_color);
+  vector<EdgeCandidates> candidates(slices.size());
+  vector<SliceCost> costs(slices.size());
+  const auto paint_slice = [&work_graph, &slices, &candidates, &costs,
+                            graph_seed](size_t index) {
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t random_draws_num = thread_random_draws_num;
+    const auto& slice = slices[index];
+    seed_thread_engine(
+        uni_cpp_practice::random_engine::mix_seed(graph_seed, slice.stream),
+        slice.index);
+    add_color_candidates(work_graph, slice, candidates[index]);
+    costs[index] = {std::chrono::steady_clock::now() - start,
+                    thread_random_draws_num - random_draws_num};
+  };
+
+  run_slice_jobs(slices.size(), in_parallel, paint_slice);
+
+  const auto merge_start = std::chrono::steady_clock::now();
+  for (const auto& slice_candidates : candidates)
+    for (const auto& [from_vertex_id, to_vertex_id] : slice_candidates)
+      if (!work_graph.is_connected(from_vertex_id, to_vertex_id))
+        work_graph.connect_vertices(from_vertex_id, to_vertex_id, false);
+  if (stats == nullptr)
+    return;
+
+  stats->get_duration(Phase::Merge) +=
+      std::chrono::steady_clock::now() - merge_start;
+  // Phases are in the order of the colors, after the gray one.
+  static_assert(static_cast<int>(Phase::Red) ==
+                static_cast<int>(Edge::Color::Red));
+  for (size_t i = 0; i < slices.size(); i++) {
+    stats->get_duration(static_cast<Phase>(slices[i].color)) +=
+        costs[i].duration;
+    stats->random_draws_num += costs[i].random_draws_num;
+  }
 }
 
+// Parents `[begin, end)` of the layer being grown, with a bit per child
+// slot and where their children go in the next layer.
+struct GraySlice {
+  size_t begin = 0;
+  size_t end = 0;
+  uni_cpp_practice::bernoulli_mask::Mask children_mask;
+  size_t children_num = 0;
+  size_t first_child_index = 0;
+};
+
 }  // namespace
 
 namespace uni_cpp_practice {
 
-void GraphGenerator::generate_gray_branch(Graph& work_graph,
-                                          std::mutex& graph_mutex,
-                                          const VertexId& parent_vertex_id,
-                                          int current_depth) const {
-  const int depth = params_.depth;
-  const VertexId new_vertex_id = [&work_graph, &graph_mutex,
-                                  &parent_vertex_id]() {
-    const std::lock_guard lock(graph_mutex);
-    const auto new_vertex_id = work_graph.add_vertex();
-    work_graph.connect_vertices(parent_vertex_id, new_vertex_id, true);
-    return new_vertex_id;
-  }();
-
-  if (current_depth == depth)
-    return;
+// Grows the tree a layer at a time. Every slice of parents flips their
+// child slots and counts the children, an exclusive prefix sum over the
+// slices gives each one a contiguous range of the next layer, and the
+// slices fill their ranges in place. A slot draws counter `i` of the layer
+// key, so neither the slicing nor the threads change the tree.
+uint64_t GraphGenerator::generate_new_vertices(Graph& graph,
+                                               uint64_t graph_seed) const {
+  const size_t slots_num = params_.new_vertices_num;
+  const uint64_t gray_seed = random_engine::mix_seed(graph_seed, GRAY_STREAM);
+  const bool in_parallel = !params_.run_on_calling_thread;
+  vector<GraySlice> slices;
+  vector<VertexId> parent_ids;
+  uint64_t random_draws_num = 0;
 
-  const double probability =
-      static_cast<double>(current_depth) / static_cast<double>(depth);
+  // Children of the root are always there, even for a zero depth.
+  for (int depth = 0; depth == 0 || depth < params_.depth; depth++) {
+    const auto& layer = graph.get_vertices_at_depth(depth);
+    const double probability =
+        depth == 0 ? 1.0
+                   : 1.0 - static_cast<double>(depth) /
+                               static_cast<double>(params_.depth);
+    const uint64_t layer_key = random_engine::mix_seed(gray_seed, depth);
 
-  for (int i = 0; i < params_.new_vertices_num; i++) {
-    if (get_real_random_number() > probability) {
-      generate_gray_branch(work_graph, graph_mutex, new_vertex_id,
-                           current_depth + 1);
+    slices.resize((layer.size() + GRAY_SLICE_SIZE - 1) / GRAY_SLICE_SIZE);
+    const auto count_children = [&slices, &layer, slots_num, probability,
+                                 layer_key](size_t index) {
+      auto& slice = slices[index];
+      slice.begin = index * GRAY_SLICE_SIZE;
+      slice.end = std::min(slice.begin + GRAY_SLICE_SIZE, layer.size());
+      bernoulli_mask::fill(slice.children_mask,
+                           (slice.end - slice.begin) * slots_num, probability,
+                           layer_key, slice.begin * slots_num);
+      slice.children_num = bernoulli_mask::count(slice.children_mask);
+    };
+    run_slice_jobs(slices.size(), in_parallel, count_children);
+    random_draws_num += layer.size() * slots_num;
+
+    size_t children_num = 0;
+    for (auto& slice : slices) {
+      slice.first_child_index = children_num;
+      children_num += slice.children_num;
     }
+    if (children_num == 0)
+      break;
+
+    parent_ids.resize(children_num);
+    const auto write_children = [&slices, &layer, &parent_ids,
+                                 slots_num](size_t index) {
+      const auto& slice = slices[index];
+      size_t child_index = slice.first_child_index;
+      bernoulli_mask::for_each_success(
+          slice.children_mask,
+          [&layer, &parent_ids, &slice, &child_index, slots_num](size_t slot) {
+            parent_ids[child_index++] = layer[slice.begin + slot / slots_num];
+          });
+    };
+    run_slice_jobs(slices.size(), in_parallel, write_children);
+    graph.add_gray_layer(parent_ids);
   }
+  return random_draws_num;
 }
 
-void GraphGenerator::generate_new_vertices(
-    Graph& graph,
-    const VertexId& parent_vertex_id) const {
-  std::list<std::function<void()>> jobs;
-  std::atomic<int> completed_jobs = 0;
-  std::mutex graph_mutex;
-  for (int i = 0; i < params_.new_vertices_num; i++)
-    jobs.emplace_back(
-        [this, &graph, &completed_jobs, &graph_mutex, parent_vertex_id]() {
-          generate_gray_branch(graph, graph_mutex, parent_vertex_id, 1);
-          completed_jobs++;
-        });
-
-  std::atomic<bool> should_terminate = false;
-  std::mutex jobs_mutex;
-  auto worker = [&should_terminate, &jobs_mutex, &jobs]() {
-    while (true) {
-      if (should_terminate) {
-        return;
-      }
-      const auto job_optional =
-          [&jobs_mutex, &jobs]() -> std::optional<std::function<void()>> {
-        const std::lock_guard lock(jobs_mutex);
-        if (jobs.empty()) {
-          return std::nullopt;
-        }
-        const auto job = jobs.front();
-        jobs.pop_front();
-        return job;
-      }();
-      if (job_optional.has_value()) {
-        const auto& job = job_optional.value();
-        job();
-      }
-    }
+GraphGenerator::SizeEstimate GraphGenerator::estimate_size(
+    const Params& params) {
+  SizeEstimate estimate;
+  // Branch roots are added even for a zero depth.
+  const int depth =
+      params.new_vertices_num > 0 ? std::max(params.depth, 1) : 0;
+  auto& expected_at_depth = estimate.expected_vertices_num_at_depth;
+  auto& max_at_depth = estimate.max_vertices_num_at_depth;
+  const auto add_layer = [&expected_at_depth, &max_at_depth](
+                             double expected, double variance) {
+    expected_at_depth.push_back(expected);
+    max_at_depth.push_back(static_cast<int>(
+        std::ceil(expected + SIZE_QUANTILE_SIGMAS * std::sqrt(variance))));
   };
 
-  const auto threads_number =
-      std::min(params_.new_vertices_num, MAX_THREADS_COUNT);
-  auto threads = std::vector<std::thread>();
-  threads.reserve(threads_number);
-
-  for (int i = 0; i < threads_number; ++i) {
-    threads.emplace_back(worker);
+  // The root and the branch roots are always there.
+  add_layer(1, 0);
+  double expected = params.new_vertices_num;
+  double variance = 0;
+  double deviations_sum = 0;
+  for (int current_depth = 1; current_depth <= depth; current_depth++) {
+    add_layer(expected, variance);
+    deviations_sum += std::sqrt(variance);
+    if (current_depth == depth)
+      break;
+    // Every vertex has Binomial(new_vertices_num, probability) children.
+    const double probability = 1.0 - static_cast<double>(current_depth) /
+                                         static_cast<double>(params.depth);
+    const double children_mean = params.new_vertices_num * probability;
+    const double children_variance = children_mean * (1.0 - probability);
+    variance = expected * children_variance +
+               children_mean * children_mean * variance;
+    expected *= children_mean;
   }
 
-  while (completed_jobs != params_.new_vertices_num) {
+  for (const double layer_expected : expected_at_depth)
+    estimate.expected_vertices_num += layer_expected;
+  // Layers are positively correlated, summing deviations is on the safe
+  // side.
+  estimate.max_vertices_num = static_cast<int>(std::ceil(
+      estimate.expected_vertices_num + SIZE_QUANTILE_SIGMAS * deviations_sum));
+
+  auto& expected_by_color = estimate.expected_edges_num_by_color;
+  const auto color_index = [](const Edge::Color& color) {
+    return static_cast<int>(color);
+  };
+  expected_by_color[color_index(Edge::Color::Gray)] =
+      estimate.expected_vertices_num - 1;
+  expected_by_color[color_index(Edge::Color::Green)] =
+      GREEN_TRASHOULD * estimate.expected_vertices_num;
+  for (int current_depth = 1; current_depth <= depth; current_depth++)
+    expected_by_color[color_index(Edge::Color::Blue)] +=
+        BLUE_TRASHOULD * std::max(expected_at_depth[current_depth] - 1, 0.0);
+  for (int current_depth = 1; current_depth < depth; current_depth++)
+    expected_by_color[color_index(Edge::Color::Yellow)] +=
+        expected_at_depth[current_depth] * current_depth / depth;
+  for (int current_depth = 0; current_depth + 2 <= depth; current_depth++)
+    expected_by_color[color_index(Edge::Color::Red)] +=
+        RED_TRASHOULD * expected_at_depth[current_depth];
+
+  // Colored edges scale with the vertices, so they get the same margin.
+  const double margin =
+      estimate.max_vertices_num / estimate.expected_vertices_num;
+  for (int color = 0; color < Edge::COLORS_NUM; color++) {
+    estimate.expected_edges_num += expected_by_color[color];
+    estimate.max_edges_num_by_color[color] =
+        static_cast<int>(std::ceil(expected_by_color[color] * margin));
   }
+  return estimate;
+}
 
-  should_terminate = true;
-  for (auto& thread : threads) {
-    thread.join();
+Graph GraphGenerator::generate(int graph_num, GenerationStats* stats) const {
+  auto graph = generate_gray_tree(graph_num, stats);
+  paint_edges(graph, graph_num, std::nullopt, stats);
+  if (stats != nullptr) {
+    stats->allocations_num = graph.get_memory_counter().get_allocations_num();
+    stats->allocated_size = graph.get_memory_counter().get_allocated_size();
   }
+  return graph;
 }
 
-Graph GraphGenerator::generate() const {
-  auto graph = Graph();
-  const auto parent_vertex_id = graph.add_vertex();
-  generate_new_vertices(graph, parent_vertex_id);
-  paint_edges(graph);
+Graph GraphGenerator::generate_gray_tree(int graph_num,
+                                         GenerationStats* stats) const {
+  const auto start = std::chrono::steady_clock::now();
+  auto graph = Graph(params_.use_arena);
+  graph.reserve(size_estimate_.max_vertices_num,
+                size_estimate_.max_edges_num_by_color,
+                size_estimate_.max_vertices_num_at_depth);
+  graph.add_vertex();
+  const uint64_t random_draws_num =
+      generate_new_vertices(graph, get_graph_seed(graph_num));
+  if (stats != nullptr) {
+    stats->get_duration(GenerationStats::Phase::Gray) +=
+        std::chrono::steady_clock::now() - start;
+    stats->random_draws_num += random_draws_num;
+  }
   return graph;
 }
 
+void GraphGenerator::paint_edges(Graph& graph,
+                                 int graph_num,
+                                 const std::optional<Edge::Color>& only_color,
+                                 GenerationStats* stats) const {
+  paint_color_edges(graph, get_graph_seed(graph_num),
+                    !params_.run_on_calling_thread, params_.batch_sampling,
+                    only_color, stats);
+}
+
+uint64_t GraphGenerator::get_graph_seed(int graph_num) const {
+  return random_engine::mix_seed(params_.seed, graph_num);
+}
+
 }  // namespace uni_cpp_practice
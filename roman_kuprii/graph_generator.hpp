@@ -1,34 +1,82 @@
 #pragma once
 
-#include <mutex>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
 
-namespace uni_cpp_practice {
+#include "generation_stats.hpp"
+#include "graph.hpp"
 
-class Graph;
+namespace uni_cpp_practice {
 
 class GraphGenerator {
  public:
   struct Params {
-    Params(int _depth, int _new_vertices_num)
-        : depth(_depth), new_vertices_num(_new_vertices_num){};
+    Params(int _depth,
+           int _new_vertices_num,
+           uint64_t _seed = std::random_device{}())
+        : depth(_depth), new_vertices_num(_new_vertices_num), seed(_seed){};
 
     int depth = 0;
     int new_vertices_num = 0;
+    // Graphs generated with the same params and `graph_num` are built from
+    // the same random sequences.
+    uint64_t seed = 0;
+    // Run the gray and color slices on the calling thread, not the pool. The
+    // graph is the same either way, this only takes scheduling out of the
+    // picture when debugging.
+    bool run_on_calling_thread = false;
+    // Draw colored edges in batches, as gaps between them or as a mask of a
+    // whole slice, instead of a trial per vertex. The distribution is the
+    // same, but the edges for a given seed differ.
+    bool batch_sampling = true;
+    // Allocate every graph from its own arena, see `Graph::Graph`.
+    bool use_arena = false;
+  };
+
+  // Sizes of the graphs generated with some params. The gray tree is a
+  // branching process with Binomial(new_vertices_num, 1 - d / depth)
+  // children at depth d, the color edges follow from the layer sizes.
+  // `max_*` fields are a high quantile, used to reserve memory up front.
+  struct SizeEstimate {
+    std::vector<double> expected_vertices_num_at_depth;
+    std::vector<int> max_vertices_num_at_depth;
+    double expected_vertices_num = 0;
+    int max_vertices_num = 0;
+    std::array<double, Edge::COLORS_NUM> expected_edges_num_by_color = {};
+    std::array<int, Edge::COLORS_NUM> max_edges_num_by_color = {};
+    double expected_edges_num = 0;
   };
 
-  Graph generate() const;
+  static SizeEstimate estimate_size(const Params& params);
+
+  // Adds what the generation took to `stats` when it is given.
+  Graph generate(int graph_num = 0, GenerationStats* stats = nullptr) const;
+
+  // The two stages of `generate`, apart so they can be measured: the gray
+  // tree, then the colored edges over it. Only the `only_color` pass is run
+  // when it is given.
+  Graph generate_gray_tree(int graph_num = 0,
+                           GenerationStats* stats = nullptr) const;
+  void paint_edges(Graph& graph,
+                   int graph_num = 0,
+                   const std::optional<Edge::Color>& only_color = std::nullopt,
+                   GenerationStats* stats = nullptr) const;
+
+  GraphGenerator(const Params& params)
+      : params_(params), size_estimate_(estimate_size(params)) {}
 
-  GraphGenerator(const Params& params) : params_(params) {}
+  const SizeEstimate& get_size_estimate() const { return size_estimate_; }
 
  private:
   Params params_;
+  SizeEstimate size_estimate_;
 
-  void generate_gray_branch(Graph& graph,
-                            std::mutex& graph_mutex,
-                            const VertexId& parent_vertex_id,
-                            int current_depth) const;
-  void generate_new_vertices(Graph& graph,
-                             const VertexId& parent_vertex_id) const;
+  uint64_t get_graph_seed(int graph_num) const;
+  // Returns the Bernoulli trials drawn.
+  uint64_t generate_new_vertices(Graph& graph, uint64_t graph_seed) const;
 };
 
 }  // namespace uni_cpp_practice
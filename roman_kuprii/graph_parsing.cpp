@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "graph.hpp"
+#include "graph_parsing.hpp"
+#include "graph_printing.hpp"
+#include "mapped_file.hpp"
+
+namespace {
+
+using uni_cpp_practice::Edge;
+using uni_cpp_practice::EdgeId;
+using uni_cpp_practice::Graph;
+using uni_cpp_practice::INVALID_ID;
+using uni_cpp_practice::VertexId;
+
+constexpr int UNKNOWN_DEPTH = -1;
+
+// Tokens of the JSON text, read straight from the buffer. Every read skips
+// the whitespace in front of the token.
+class JsonCursor {
+ public:
+  explicit JsonCursor(std::string_view json)
+      : begin_(json.data()),
+        position_(json.data()),
+        end_(json.data() + json.size()) {}
+
+  [[noreturn]] void fail(const std::string& error) const {
+    throw std::runtime_error("Bad graph JSON at byte " +
+                             std::to_string(position_ - begin_) + ": " +
+                             error);
+  }
+
+  void expect(char symbol) {
+    if (!consume(symbol))
+      fail(std::string("expected '") + symbol + "'");
+  }
+
+  bool consume(char symbol) {
+    skip_whitespace();
+    if (position_ == end_ || *position_ != symbol)
+      return false;
+    position_++;
+    return true;
+  }
+
+  int read_int() {
+    skip_whitespace();
+    int value = 0;
+    const auto [end, error] = std::from_chars(position_, end_, value);
+    if (error != std::errc())
+      fail("expected an integer");
+    position_ = end;
+    return value;
+  }
+
+  // Escapes are skipped over but left as they are, no key or color has any.
+  std::string_view read_string() {
+    expect('"');
+    const char* const begin = position_;
+    while (position_ != end_ && *position_ != '"') {
+      if (*position_ == '\\' && end_ - position_ > 1)
+        position_++;
+      position_++;
+    }
+    if (position_ == end_)
+      fail("unterminated string");
+    return std::string_view(begin, position_++ - begin);
+  }
+
+  // Calls `on_item()` at every element, which must read it.
+  template <typename OnItem>
+  void read_array(const OnItem& on_item) {
+    expect('[');
+    if (consume(']'))
+      return;
+    do
+      on_item();
+    while (consume(','));
+    expect(']');
+  }
+
+  // Calls `on_key(key)` at every value, which must read it.
+  template <typename OnKey>
+  void read_object(const OnKey& on_key) {
+    expect('{');
+    if (consume('}'))
+      return;
+    do {
+      const std::string_view key = read_string();
+      expect(':');
+      on_key(key);
+    } while (consume(','));
+    expect('}');
+  }
+
+  void skip_value() {
+    skip_whitespace();
+    if (position_ == end_)
+      fail("expected a value");
+    switch (*position_) {
+      case '"':
+        read_string();
+        return;
+      case '[':
+        read_array([this]() { skip_value(); });
+        return;
+      case '{':
+        read_object([this](std::string_view) { skip_value(); });
+        return;
+    }
+    // A number, true, false or null.
+    const char* const begin = position_;
+    while (position_ != end_ && is_literal_symbol(*position_))
+      position_++;
+    if (position_ == begin)
+      fail("expected a value");
+  }
+
+  void expect_end() {
+    skip_whitespace();
+    if (position_ != end_)
+      fail("unexpected data after the graph");
+  }
+
+ private:
+  const char* const begin_;
+  const char* position_;
+  const char* const end_;
+
+  static bool is_literal_symbol(char symbol) {
+    return std::isalnum(static_cast<unsigned char>(symbol)) ||
+           symbol == '+' || symbol == '-' || symbol == '.';
+  }
+
+  void skip_whitespace() {
+    while (position_ != end_ && (*position_ == ' ' || *position_ == '\n' ||
+                                 *position_ == '\t' || *position_ == '\r'))
+      position_++;
+  }
+};
+
+Edge::Color read_color(JsonCursor& json) {
+  const std::string_view name = json.read_string();
+  for (int color = 0; color < Edge::COLORS_NUM; color++) {
+    const std::string_view quoted_name =
+        uni_cpp_practice::graph_printing::color_to_json(
+            static_cast<Edge::Color>(color));
+    if (name == quoted_name.substr(1, quoted_name.size() - 2))
+      return static_cast<Edge::Color>(color);
+  }
+  json.fail("unknown color \"" + std::string(name) + "\"");
+}
+
+struct VertexCounts {
+  // UNKNOWN_DEPTH where none is printed.
+  std::vector<int> depths;
+  std::vector<int> edges_nums;
+  // Listed by every vertex in turn, `edges_nums` splits them into rows.
+  std::vector<EdgeId> edge_ids;
+  // The largest edge id listed, it tells how many edges follow.
+  EdgeId max_edge_id = INVALID_ID;
+
+  // Bounded by the ids listed, so a bad id cannot reserve too much.
+  int get_edges_num() const {
+    return std::min<int64_t>(max_edge_id + int64_t{1}, edge_ids.size());
+  }
+};
+
+void read_vertices(JsonCursor& json, VertexCounts& counts) {
+  json.read_array([&json, &counts]() {
+    VertexId vertex_id = INVALID_ID;
+    int depth = UNKNOWN_DEPTH;
+    int edges_num = 0;
+    json.read_object([&](std::string_view key) {
+      if (key == "id") {
+        vertex_id = json.read_int();
+      } else if (key == "edge_ids") {
+        json.read_array([&json, &counts, &edges_num]() {
+          const EdgeId edge_id = json.read_int();
+          if (edge_id < 0)
+            json.fail("negative edge id");
+          counts.edge_ids.push_back(edge_id);
+          counts.max_edge_id = std::max(counts.max_edge_id, edge_id);
+          edges_num++;
+        });
+      } else if (key == "depth") {
+        depth = json.read_int();
+        if (depth < 0)
+          json.fail("negative vertex depth");
+      } else {
+        json.skip_value();
+      }
+    });
+    if (vertex_id != static_cast<VertexId>(counts.depths.size()))
+      json.fail("expected vertex " + std::to_string(counts.depths.size()));
+    counts.depths.push_back(depth);
+    counts.edges_nums.push_back(edges_num);
+  });
+}
+
+void read_edges(JsonCursor& json, Graph& graph) {
+  json.read_array([&json, &graph]() {
+    EdgeId edge_id = INVALID_ID;
+    std::array<VertexId, 2> vertex_ids = {INVALID_ID, INVALID_ID};
+    int vertex_ids_num = 0;
+    bool has_color = false;
+    Edge::Color color = Edge::Color::Gray;
+    json.read_object([&](std::string_view key) {
+      if (key == "id") {
+        edge_id = json.read_int();
+      } else if (key == "vertex_ids") {
+        json.read_array([&json, &vertex_ids, &vertex_ids_num]() {
+          if (vertex_ids_num == 2)
+            json.fail("an edge has two vertices");
+          vertex_ids[vertex_ids_num++] = json.read_int();
+        });
+      } else if (key == "color") {
+        color = read_color(json);
+        has_color = true;
+      } else {
+        json.skip_value();
+      }
+    });
+
+    if (edge_id != graph.get_edges_num())
+      json.fail("expected edge " + std::to_string(graph.get_edges_num()));
+    if (vertex_ids_num != 2 || !graph.is_vertex_exist(vertex_ids[0]) ||
+        !graph.is_vertex_exist(vertex_ids[1]))
+      json.fail("edge " + std::to_string(edge_id) + " has bad vertices");
+    if (!has_color)
+      json.fail("edge " + std::to_string(edge_id) + " has no color");
+    if (graph.add_edge(vertex_ids[0], vertex_ids[1], color) == INVALID_ID)
+      json.fail("edge " + std::to_string(edge_id) + " is a duplicate");
+  });
+}
+
+// The edges read are added in id order, so each vertex holds its edge ids
+// sorted, and the ones it listed must be the same.
+void check_edge_ids(const JsonCursor& json,
+                    const Graph& graph,
+                    VertexCounts& counts) {
+  auto row_begin = counts.edge_ids.begin();
+  for (const auto& vertex : graph.get_vertices()) {
+    const auto row_end = row_begin + counts.edges_nums[vertex.get_id()];
+    std::sort(row_begin, row_end);
+    const auto& edge_ids = vertex.get_edges_ids();
+    if (!std::equal(row_begin, row_end, edge_ids.begin(), edge_ids.end()))
+      json.fail("edge ids of vertex " + std::to_string(vertex.get_id()) +
+                " do not match its edges");
+    row_begin = row_end;
+  }
+}
+
+// A gray edge leads one layer down, from its first vertex to the second.
+// Printers add them layer by layer, so one pass usually settles all. The
+// vertices not reached are left at UNKNOWN_DEPTH.
+std::vector<int> get_gray_tree_depths(const Graph& graph, int vertices_num) {
+  std::vector<int> depths(vertices_num, UNKNOWN_DEPTH);
+  if (!depths.empty())
+    depths[0] = 0;
+  const auto& gray_edge_ids = graph.get_edge_ids_with_color(Edge::Color::Gray);
+  bool is_changed = true;
+  while (is_changed) {
+    is_changed = false;
+    for (const auto& edge_id : gray_edge_ids) {
+      const auto& vertices = graph.get_edges()[edge_id].connected_vertices;
+      if (depths[vertices[1]] == UNKNOWN_DEPTH &&
+          depths[vertices[0]] != UNKNOWN_DEPTH) {
+        depths[vertices[1]] = depths[vertices[0]] + 1;
+        is_changed = true;
+      }
+    }
+  }
+  return depths;
+}
+
+// Printing a depth is optional, but one that is printed must be the depth
+// the gray tree gives.
+void check_depths(const JsonCursor& json,
+                  const std::vector<int>& printed_depths,
+                  const std::vector<int>& depths) {
+  for (size_t vertex_id = 0; vertex_id < depths.size(); vertex_id++) {
+    if (depths[vertex_id] == UNKNOWN_DEPTH)
+      json.fail("vertex " + std::to_string(vertex_id) +
+                " is not reached by gray edges");
+    if (printed_depths[vertex_id] != UNKNOWN_DEPTH &&
+        printed_depths[vertex_id] != depths[vertex_id])
+      json.fail("vertex " + std::to_string(vertex_id) + " has depth " +
+                std::to_string(printed_depths[vertex_id]) +
+                ", its gray edges give " + std::to_string(depths[vertex_id]));
+  }
+}
+
+}  // namespace
+
+namespace uni_cpp_practice {
+
+namespace graph_parsing {
+
+Graph parse_graph(std::string_view json_text, bool use_arena) {
+  JsonCursor json(json_text);
+  Graph graph(use_arena);
+  int printed_depth = UNKNOWN_DEPTH;
+  bool has_vertices = false;
+  VertexCounts counts;
+
+  json.read_object([&](std::string_view key) {
+    if (key == "depth") {
+      printed_depth = json.read_int();
+    } else if (key == "vertices") {
+      if (has_vertices)
+        json.fail("vertices are given twice");
+      has_vertices = true;
+      read_vertices(json, counts);
+
+      // Vertices and edges are counted exactly, but of the colors only the
+      // gray tree is known. The other edges are booked as green, which
+      // sizes the edge list and the pair set, the lists by color may grow.
+      const int vertices_num = counts.depths.size();
+      std::array<int, Edge::COLORS_NUM> edges_num_by_color = {};
+      edges_num_by_color[static_cast<int>(Edge::Color::Gray)] =
+          std::max(vertices_num - 1, 0);
+      edges_num_by_color[static_cast<int>(Edge::Color::Green)] =
+          std::max(counts.get_edges_num() - vertices_num + 1, 0);
+      graph.reserve(vertices_num, edges_num_by_color, {});
+      for (int i = 0; i < vertices_num; i++)
+        graph.reserve_edges(graph.add_vertex(), counts.edges_nums[i]);
+    } else if (key == "edges") {
+      if (!has_vertices || graph.get_edges_num() > 0)
+        json.fail("edges must follow the vertices once");
+      read_edges(json, graph);
+    } else {
+      json.skip_value();
+    }
+  });
+  json.expect_end();
+
+  check_edge_ids(json, graph, counts);
+  const auto depths = get_gray_tree_depths(graph, counts.depths.size());
+  check_depths(json, counts.depths, depths);
+  graph.set_vertex_depths(depths);
+  if (printed_depth != UNKNOWN_DEPTH && printed_depth != graph.get_depth())
+    json.fail("depth " + std::to_string(printed_depth) + " does not match " +
+              "the vertices");
+  return graph;
+}
+
+Graph read_graph(const std::string& file_path, bool use_arena) {
+  const MappedFile file(file_path);
+  file.advise_sequential();
+  try {
+    return parse_graph(file.get_text(), use_arena);
+  } catch (const std::runtime_error& error) {
+    throw std::runtime_error(file_path + ": " + error.what());
+  }
+}
+
+}  // namespace graph_parsing
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "graph.hpp"
+
+namespace uni_cpp_practice {
+
+// Reads graphs back from JSON, in a single pass over the text and without
+// building any document on the way.
+namespace graph_parsing {
+
+// Rebuilds the graph from the JSON of `graph_printing::print_graph`, or of
+// any printer using the same keys: "depth", "vertices" of "id", "edge_ids"
+// and an optional "depth", "edges" of "id", "vertex_ids" and "color". Keys
+// may come in any order with any whitespace between tokens, other keys are
+// skipped. Vertices must come before edges and ids must count up from 0.
+// The edge ids a vertex lists must be those of its edges, in any order.
+// Vertex depths are rebuilt from the gray edges, a printed one must match.
+//
+// Throws std::runtime_error naming the byte offset of the first error.
+Graph parse_graph(std::string_view json, bool use_arena = false);
+
+// Maps the file and parses it.
+Graph read_graph(const std::string& file_path, bool use_arena = false);
+
+}  // namespace graph_parsing
+
+}  // namespace uni_cpp_practice
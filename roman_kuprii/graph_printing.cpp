@@ -1,19 +1,148 @@
+#include <algorithm>
 #include <array>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
-#include <memory>
-#include <sstream>
+#include <charconv>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "file_writer.hpp"
+#include "frozen_graph.hpp"
 #include "graph.hpp"
 #include "graph_printing.hpp"
+#include "thread_pool.hpp"
 
 namespace {
 
-using std::to_string;
-using std::vector;
+using uni_cpp_practice::EdgeId;
+using uni_cpp_practice::FrozenGraph;
+using uni_cpp_practice::VertexId;
+
+constexpr std::string_view EDGES_BEGIN = " ], \"edges\": [ ";
+constexpr std::string_view GRAPH_END = " ] }\n";
+
+// Vertices or edges rendered by one job of `print_graph_in_parallel`.
+constexpr int PRINT_CHUNK_SIZE = 1 << 14;
+// Enough for any int with its sign.
+constexpr size_t MAX_NUMBER_LENGTH = 11;
+
+// Has the writing methods of FileWriter but appends to a string, so a chunk
+// of the graph is rendered apart from the file.
+class StringWriter {
+ public:
+  explicit StringWriter(std::string& text) : text_(text) {}
+
+  void write(std::string_view text) { text_ += text; }
+  void write(int number) {
+    std::array<char, MAX_NUMBER_LENGTH> digits;
+    const auto end =
+        std::to_chars(digits.data(), digits.data() + digits.size(), number)
+            .ptr;
+    text_.append(digits.data(), end);
+  }
+
+ private:
+  std::string& text_;
+};
+
+// The writers below are shared by the sequential and the parallel printing,
+// which is what keeps their output the same.
+template <typename Writer>
+void write_edge(const FrozenGraph& graph,
+                const EdgeId& edge_id,
+                Writer& writer) {
+  const auto& edge_vertices = graph.get_edge_vertices(edge_id);
+  writer.write("{ \"id\": ");
+  writer.write(edge_id);
+  writer.write(", \"vertex_ids\": [");
+  writer.write(edge_vertices[0]);
+  writer.write(", ");
+  writer.write(edge_vertices[1]);
+  writer.write("], \"color\": ");
+  writer.write(uni_cpp_practice::graph_printing::color_to_json(
+      graph.get_edge_color(edge_id)));
+  writer.write(" }");
+}
+
+template <typename Writer>
+void write_vertex(const FrozenGraph& graph,
+                  const VertexId& vertex_id,
+                  Writer& writer) {
+  writer.write("{ \"id\": ");
+  writer.write(vertex_id);
+  writer.write(", \"edge_ids\": [");
+  bool is_first = true;
+  for (const auto& edge_id : graph.get_edge_ids(vertex_id)) {
+    if (!is_first)
+      writer.write(", ");
+    writer.write(edge_id);
+    is_first = false;
+  }
+  writer.write("] }");
+}
+
+// Vertices `[begin, end)` of the "vertices" array, each but the very first
+// one after a separator.
+template <typename Writer>
+void write_vertices(const FrozenGraph& graph,
+                    VertexId begin,
+                    VertexId end,
+                    Writer& writer) {
+  for (VertexId vertex_id = begin; vertex_id < end; vertex_id++) {
+    if (vertex_id > 0)
+      writer.write(", ");
+    write_vertex(graph, vertex_id, writer);
+  }
+}
+
+template <typename Writer>
+void write_edges(const FrozenGraph& graph,
+                 EdgeId begin,
+                 EdgeId end,
+                 Writer& writer) {
+  for (EdgeId edge_id = begin; edge_id < end; edge_id++) {
+    if (edge_id > 0)
+      writer.write(", ");
+    write_edge(graph, edge_id, writer);
+  }
+}
+
+void write_graph_begin(const FrozenGraph& graph,
+                       uni_cpp_practice::FileWriter& writer) {
+  writer.write("{ \"depth\": ");
+  writer.write(graph.get_depth());
+  writer.write(", \"vertices\": [ ");
+}
+
+// Renders items `[0, items_num)` in chunks on the pool and writes them in
+// order. A round of chunks is rendered at a time, so the memory used stays
+// bounded, and the buffers are reused from round to round.
+template <typename WriteChunk>
+void write_in_chunks(int items_num,
+                     uni_cpp_practice::FileWriter& writer,
+                     const WriteChunk& write_chunk) {
+  auto& thread_pool = uni_cpp_practice::ThreadPool::get_thread_pool();
+  const int round_size = 2 * thread_pool.get_threads_count();
+  std::vector<std::string> chunks(round_size);
+  for (int round_begin = 0; round_begin < items_num;
+       round_begin += round_size * PRINT_CHUNK_SIZE) {
+    const int chunks_num =
+        std::min(round_size, (items_num - round_begin + PRINT_CHUNK_SIZE - 1) /
+                                 PRINT_CHUNK_SIZE);
+    uni_cpp_practice::TaskGroup chunk_jobs(thread_pool);
+    for (int chunk = 0; chunk < chunks_num; chunk++)
+      chunk_jobs.run([&chunks, &write_chunk, items_num, round_begin, chunk]() {
+        const int begin = round_begin + chunk * PRINT_CHUNK_SIZE;
+        const int end = std::min(begin + PRINT_CHUNK_SIZE, items_num);
+        chunks[chunk].clear();
+        StringWriter chunk_writer(chunks[chunk]);
+        write_chunk(begin, end, chunk_writer);
+      });
+    chunk_jobs.wait();
+    // Chunks larger than the writer's buffer go to the file directly.
+    for (int chunk = 0; chunk < chunks_num; chunk++)
+      writer.write(chunks[chunk]);
+  }
+}
 
 }  // namespace
 
@@ -21,7 +150,7 @@ namespace uni_cpp_practice {
 
 namespace graph_printing {
 
-std::string color_to_string(const Edge::Color& color) {
+std::string_view color_to_json(const Edge::Color& color) {
   switch (color) {
     case Edge::Color::Gray:
       return "\"gray\"";
@@ -34,62 +163,48 @@ std::string color_to_string(const Edge::Color& color) {
     case Edge::Color::Red:
       return "\"red\"";
   }
+  return "";
 }
 
-std::string edge_to_json(const Edge& edge) {
-  std::string res;
-  res = "{ \"id\": ";
-  res += to_string(edge.id);
-  res += ", \"vertex_ids\": [";
-  res += to_string(edge.connected_vertices[0]);
-  res += ", ";
-  res += to_string(edge.connected_vertices[1]);
-  res += "], \"color\": ";
-  res += color_to_string(edge.color);
-  res += " }";
-  return res;
+std::string color_to_string(const Edge::Color& color) {
+  return std::string(color_to_json(color));
 }
 
-std::string vertex_to_json(const Vertex& vertex) {
-  std::string res;
-  res = "{ \"id\": ";
-  res += to_string(vertex.get_id()) + ", \"edge_ids\": [";
-  for (const auto& edge_id : vertex.get_edges_ids()) {
-    res += to_string(edge_id);
-    res += ", ";
-  }
-  if (vertex.get_edges_ids().size() > 0) {
-    res.pop_back();
-    res.pop_back();
-  }
-  res += "] }";
-  return res;
+void print_edge(const FrozenGraph& graph,
+                const EdgeId& edge_id,
+                FileWriter& writer) {
+  write_edge(graph, edge_id, writer);
 }
 
-std::string graph_to_json(const Graph& graph) {
-  std::string res;
-  res = "{ \"depth\": ";
-  res += to_string(graph.get_depth());
-  res += ", \"vertices\": [ ";
-  for (const auto& vertex : graph.get_vertices()) {
-    res += vertex_to_json(vertex);
-    res += ", ";
-  }
-  if (graph.get_vertices().size()) {
-    res.pop_back();
-    res.pop_back();
-  }
-  res += " ], \"edges\": [ ";
-  for (const auto& edge : graph.get_edges()) {
-    res += edge_to_json(edge);
-    res += ", ";
-  }
-  if (graph.get_edges().size() > 0) {
-    res.pop_back();
-    res.pop_back();
-  }
-  res += " ] }\n";
-  return res;
+void print_vertex(const FrozenGraph& graph,
+                  const VertexId& vertex_id,
+                  FileWriter& writer) {
+  write_vertex(graph, vertex_id, writer);
+}
+
+void print_graph(const FrozenGraph& graph, FileWriter& writer) {
+  write_graph_begin(graph, writer);
+  write_vertices(graph, 0, graph.get_vertices_num(), writer);
+  writer.write(EDGES_BEGIN);
+  write_edges(graph, 0, graph.get_edges_num(), writer);
+  writer.write(GRAPH_END);
+}
+
+void print_graph_in_parallel(const FrozenGraph& graph, FileWriter& writer) {
+  if (graph.get_vertices_num() + graph.get_edges_num() <= PRINT_CHUNK_SIZE)
+    return print_graph(graph, writer);
+
+  write_graph_begin(graph, writer);
+  write_in_chunks(graph.get_vertices_num(), writer,
+                  [&graph](int begin, int end, StringWriter& chunk_writer) {
+                    write_vertices(graph, begin, end, chunk_writer);
+                  });
+  writer.write(EDGES_BEGIN);
+  write_in_chunks(graph.get_edges_num(), writer,
+                  [&graph](int begin, int end, StringWriter& chunk_writer) {
+                    write_edges(graph, begin, end, chunk_writer);
+                  });
+  writer.write(GRAPH_END);
 }
 
 }  // namespace graph_printing
@@ -1,18 +1,33 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+
+#include "graph.hpp"
 
 namespace uni_cpp_practice {
 
-class Graph;
+class FileWriter;
+class FrozenGraph;
 
 namespace graph_printing {
 
+// Quoted color name, the way it appears in the JSON.
+std::string_view color_to_json(const Edge::Color& color);
 std::string color_to_string(const Edge::Color& color);
 
-std::string graph_to_json(const Graph& graph);
-std::string vertex_to_json(const Vertex& graph);
-std::string edge_to_json(const Graph& graph);
+// Streams the graph as JSON, nothing is built in memory on the way.
+void print_graph(const FrozenGraph& graph, FileWriter& writer);
+// Same bytes as `print_graph`, but the vertices and edges are rendered in
+// chunks on the thread pool, each into a buffer of its own, and the buffers
+// are written in order. Small graphs are printed as they are.
+void print_graph_in_parallel(const FrozenGraph& graph, FileWriter& writer);
+void print_vertex(const FrozenGraph& graph,
+                  const VertexId& vertex_id,
+                  FileWriter& writer);
+void print_edge(const FrozenGraph& graph,
+                const EdgeId& edge_id,
+                FileWriter& writer);
 
 }  // namespace graph_printing
 
@@ -1,31 +1,84 @@
 #pragma once
 
-#include <fstream>
-#include <iostream>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 
 namespace uni_cpp_practice {
 
 class Graph;
 
+// Records are queued into a lock-free ring and written to stdout and the
+// log file by a background thread, so `log` never waits for the terminal
+// or the disk.
 class Logger {
  public:
+  // What `log` does when the ring is full.
+  enum class OverflowPolicy { Block, Drop };
+
   static Logger& get_logger() {
     static Logger logger;
     return logger;
   }
 
-  void log(const std::string& text);
+  void log(std::string text);
 
   void set_output(const std::optional<std::string>& file_path);
+  // Records go to stdout as well as to the file unless turned off.
+  void set_stdout_enabled(bool is_enabled) { is_stdout_enabled_ = is_enabled; }
+
+  void set_overflow_policy(const OverflowPolicy& policy) {
+    overflow_policy_ = policy;
+  }
+
+  // Blocks until every record logged before the call is written.
+  void flush();
 
   ~Logger();
 
  private:
-  std::optional<std::ofstream> file_stream_ = std::nullopt;
+  static constexpr size_t RING_SIZE = 1 << 12;
+
+  // `sequence` tells whose turn the slot is: equal to the position for the
+  // producer that will fill it, one past it for the flush thread.
+  struct Slot {
+    std::atomic<uint64_t> sequence;
+    std::string text;
+  };
+
+  std::array<Slot, RING_SIZE> ring_;
+  std::atomic<uint64_t> enqueue_position_ = 0;
+  // Owned by the flush thread.
+  uint64_t dequeue_position_ = 0;
+  std::atomic<OverflowPolicy> overflow_policy_ = OverflowPolicy::Block;
+  std::atomic<uint64_t> dropped_records_ = 0;
+  std::atomic<bool> is_stdout_enabled_ = true;
+
+  // Guards the file descriptor, taken by the flush thread per batch.
+  std::mutex output_mutex_;
+  int file_descriptor_ = -1;
+
+  std::mutex flush_mutex_;
+  std::condition_variable flush_cv_;
+  std::condition_variable written_cv_;
+  std::atomic<bool> is_flush_thread_sleeping_ = false;
+  uint64_t written_position_ = 0;
+  bool should_terminate_ = false;
+  std::thread flush_thread_;
+
+  Logger();
+  bool try_enqueue(std::string& text);
+  bool try_dequeue(std::string& text);
+  void wake_flush_thread();
+  void run_flush_thread();
+  void write_batch(const std::string& batch);
 
-  Logger() = default;
   Logger(const Logger& root) = delete;
   Logger& operator=(const Logger&) = delete;
   Logger(Logger&&) = delete;
@@ -1,30 +1,62 @@
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstdio>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "date_time.hpp"
+#include "frozen_graph.hpp"
+#include "generation_stats.hpp"
 #include "graph.hpp"
+#include "graph_generator.hpp"
 #include "graph_printing.hpp"
 #include "logger.hpp"
 
 namespace {
 
-const std::string JSON_GRAPH_FILENAME = "temp/graph_";
-
 using std::to_string;
 
-std::string get_datetime() {
-  const auto date_time = std::chrono::system_clock::now();
-  const auto date_time_t = std::chrono::system_clock::to_time_t(date_time);
-  std::stringstream date_time_string;
-  date_time_string << std::put_time(std::localtime(&date_time_t),
-                                    "%Y.%m.%d %H:%M:%S");
-  return date_time_string.str();
+// Relative error of the size estimate, like "+1.5%".
+std::string get_prediction_error(double actual, double expected) {
+  std::array<char, 16> text;
+  std::snprintf(text.data(), text.size(), "%+.1f%%",
+                100.0 * (actual - expected) / expected);
+  return text.data();
+}
+
+// Milliseconds with microseconds, like "1.234 ms".
+std::string get_milliseconds(const std::chrono::nanoseconds& duration) {
+  std::array<char, 32> text;
+  std::snprintf(text.data(), text.size(), "%.3f ms",
+                std::chrono::duration<double, std::milli>(duration).count());
+  return text.data();
+}
+
+// Nearest rank percentile of sorted `values`.
+template <typename T>
+T get_percentile(const std::vector<T>& values, int percent) {
+  const size_t rank = (values.size() * percent + 99) / 100;
+  return values[std::max<size_t>(rank, 1) - 1];
+}
+
+constexpr std::array<int, 3> SUMMARY_PERCENTS = {50, 90, 99};
+
+// "p50 x, p90 y, p99 z, max w" over `values`, which get sorted.
+template <typename T, typename Format>
+std::string get_percentiles(std::vector<T>& values, const Format& format) {
+  std::sort(values.begin(), values.end());
+  std::string res;
+  for (const int percent : SUMMARY_PERCENTS)
+    res += "p" + to_string(percent) + " " +
+           format(get_percentile(values, percent)) + ", ";
+  res += "max " + format(values.back());
+  return res;
 }
 
 }  // namespace
@@ -33,50 +65,94 @@ namespace uni_cpp_practice {
 
 namespace logging_helping {
 
-void write_graph(const Graph& graph, int graph_num) {
-  std::ofstream out;
-  const std::string filename =
-      JSON_GRAPH_FILENAME + std::to_string(graph_num) + ".json";
-  out.open(filename, std::ofstream::out | std::ofstream::trunc);
-  out << graph_printing::graph_to_json(graph);
-  out.close();
-}
-
 std::string write_log_start(int graph_num) {
-  std::string res = get_datetime();
-  res += ": Graph " + to_string(graph_num) + ", Generation Started";
+  std::string res;
+  date_time::append_date_time(res);
+  res += ": Graph ";
+  res += to_string(graph_num);
+  res += ", Generation Started";
   return res;
 }
 
-std::string write_log_end(Graph& work_graph, int graph_num) {
-  std::string res = get_datetime();
+std::string write_log_end(const FrozenGraph& work_graph,
+                          int graph_num,
+                          const GraphGenerator::SizeEstimate& size_estimate,
+                          const GenerationStats& stats) {
+  std::string res;
+  date_time::append_date_time(res);
   res += ": Graph " + to_string(graph_num) + ", Generation Ended {\n";
   res += "  depth: " + to_string(work_graph.get_depth()) + ",\n";
   res += "  vertices: " + to_string(work_graph.get_vertices_num()) + ", [";
 
-  std::vector<int> depth_count;
-  for (int iter = 0; iter <= work_graph.get_depth(); iter++)
-    depth_count.emplace_back(0);
-  for (const auto& vertex : work_graph.get_vertices()) {
-    depth_count[vertex.depth]++;
-  }
-  for (const auto& depth : depth_count) {
-    res += to_string(depth) + ", ";
+  for (int depth = 0; depth <= work_graph.get_depth(); depth++) {
+    res += to_string(work_graph.get_vertices_num_at_depth(depth)) + ", ";
   }
   res.pop_back();
   res.pop_back();
   res += "],\n";
   res += "  edges: " + to_string(work_graph.get_edges_num()) + ", {";
 
-  const auto colors = std::vector<Edge::Color>(
-      {Edge::Color::Gray, Edge::Color::Green, Edge::Color::Blue,
-       Edge::Color::Yellow, Edge::Color::Red});
+  constexpr std::array<Edge::Color, Edge::COLORS_NUM> colors = {
+      Edge::Color::Gray, Edge::Color::Green, Edge::Color::Blue,
+      Edge::Color::Yellow, Edge::Color::Red};
 
   for (const auto& color : colors) {
     res += graph_printing::color_to_string(color) + ": " +
-           to_string(work_graph.get_edge_ids_with_color(color).size()) + ", ";
+           to_string(work_graph.get_edges_num(color)) + ", ";
   }
   res.pop_back();
+  res += "\n  prediction error: vertices " +
+         get_prediction_error(work_graph.get_vertices_num(),
+                              size_estimate.expected_vertices_num) +
+         ", edges " +
+         get_prediction_error(work_graph.get_edges_num(),
+                              size_estimate.expected_edges_num);
+  res += "\n  phases: ";
+  for (int phase = 0; phase < GenerationStats::PHASES_NUM; phase++) {
+    res += GenerationStats::PHASE_NAMES[phase];
+    res += " " + get_milliseconds(stats.phase_durations[phase]) + ", ";
+  }
+  res.pop_back();
+  res.pop_back();
+  res += "\n  random draws: " + to_string(stats.random_draws_num);
+  res += ", allocations: " + to_string(stats.allocations_num) + ", " +
+         to_string(stats.allocated_size) + " bytes";
+  res += "\n}\n";
+  return res;
+}
+
+// Percentiles of every phase and counter over the graphs of a batch.
+std::string write_stats_summary(const std::vector<GenerationStats>& stats) {
+  std::string res;
+  date_time::append_date_time(res);
+  res += ": " + to_string(stats.size()) + " Graphs Generated";
+  if (stats.empty())
+    return res;
+
+  res += " {\n";
+  std::vector<std::chrono::nanoseconds> durations(stats.size());
+  for (int phase = 0; phase < GenerationStats::PHASES_NUM; phase++) {
+    for (size_t i = 0; i < stats.size(); i++)
+      durations[i] = stats[i].phase_durations[phase];
+    res += "  ";
+    res += GenerationStats::PHASE_NAMES[phase];
+    res += ": " + get_percentiles(durations, get_milliseconds) + ",\n";
+  }
+
+  const auto to_text = [](uint64_t value) { return to_string(value); };
+  const std::array<std::pair<const char*, uint64_t GenerationStats::*>, 3>
+      counters = {{{"random draws", &GenerationStats::random_draws_num},
+                   {"allocations", &GenerationStats::allocations_num},
+                   {"allocated bytes", &GenerationStats::allocated_size}}};
+  std::vector<uint64_t> values(stats.size());
+  for (const auto& [name, counter] : counters) {
+    for (size_t i = 0; i < stats.size(); i++)
+      values[i] = stats[i].*counter;
+    res += "  " + std::string(name) + ": " +
+           get_percentiles(values, to_text) + ",\n";
+  }
+  res.pop_back();
+  res.pop_back();
   res += "\n}\n";
   return res;
 }
@@ -2,7 +2,13 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "bounded_queue.hpp"
+#include "frozen_graph.hpp"
+#include "generation_stats.hpp"
+#include "graph_archive.hpp"
 #include "graph.hpp"
 #include "graph_generation_controller.hpp"
 #include "graph_generator.hpp"
@@ -15,15 +21,25 @@ constexpr int INVALID_NEW_DEPTH = -1;
 constexpr int INVALID_NEW_VERTICES_NUMBER = -1;
 constexpr int INVALID_THREADS_NUMBER = 0;
 const std::string LOG_FILENAME = "temp/log.txt";
+const std::string GRAPHS_ARCHIVE_FILENAME = "temp/graphs.archive";
 const std::string DIRECTORY_NAME = "temp";
 
 const int MAX_THREADS_COUNT = std::thread::hardware_concurrency();
 
+using uni_cpp_practice::BoundedQueue;
+using uni_cpp_practice::FrozenGraph;
+using uni_cpp_practice::GenerationStats;
 using uni_cpp_practice::Graph;
 using uni_cpp_practice::GraphGenerator;
 using uni_cpp_practice::Logger;
 using uni_cpp_practice::graph_generation_controller::GraphGenerationController;
 
+struct FinishedGraph {
+  FrozenGraph graph;
+  int index;
+  GenerationStats stats;
+};
+
 int handle_graphs_number_input() {
   int graphs_quantity = GRAPHS_NUMBER;
   do {
@@ -76,22 +92,47 @@ int main() {
   const int new_vertices_num = handle_vertices_number_input();
   const int threads_count = handle_threads_number_input();
   const auto params = GraphGenerator::Params(depth, new_vertices_num);
+  logger.log("Seed: " + std::to_string(params.seed));
 
   auto generation_controller =
       GraphGenerationController(threads_count, graphs_count, params);
-  auto graphs = std::vector<Graph>();
 
-  graphs.reserve(graphs_count);
+  // Finished graphs are handed over to the writer thread, so generation
+  // never waits for the disk unless the writer is a whole queue behind. All
+  // of them go to one archive, a file per graph would cost more in
+  // metadata than in data for small graphs.
+  BoundedQueue<FinishedGraph> finished_graphs(threads_count);
+  const auto size_estimate = GraphGenerator::estimate_size(params);
+  uni_cpp_practice::graph_archive::Writer archive(GRAPHS_ARCHIVE_FILENAME);
+  // Owned by the writer thread until it is joined.
+  std::vector<GenerationStats> batch_stats;
+  std::thread writer_thread([&logger, &finished_graphs, &size_estimate,
+                             &archive, &params, &batch_stats]() {
+    while (auto finished_graph = finished_graphs.pop()) {
+      auto& stats = finished_graph->stats;
+      archive.write_graph(finished_graph->graph, finished_graph->index, params,
+                          &stats);
+      logger.log(uni_cpp_practice::logging_helping::write_log_end(
+          finished_graph->graph, finished_graph->index, size_estimate, stats));
+      batch_stats.push_back(stats);
+    }
+  });
 
   generation_controller.generate(
       [&logger](int index) {
         logger.log(uni_cpp_practice::logging_helping::write_log_start(index));
       },
-      [&logger, &graphs](uni_cpp_practice::Graph graph, int index) {
-        logger.log(
-            uni_cpp_practice::logging_helping::write_log_end(graph, index));
-        graphs.push_back(graph);
-        uni_cpp_practice::logging_helping::write_graph(graph, index);
+      [&finished_graphs](uni_cpp_practice::Graph graph, int index,
+                         const GenerationStats& stats) {
+        // Compacted on the generator thread, outside of any lock, so graphs
+        // finishing together freeze in parallel. The queue then holds only
+        // the flat arrays and the graph itself is freed right away.
+        finished_graphs.push({FrozenGraph(graph), index, stats});
       });
+  finished_graphs.close();
+  writer_thread.join();
+  archive.close();
+  logger.log(
+      uni_cpp_practice::logging_helping::write_stats_summary(batch_stats));
   return 0;
 }
@@ -0,0 +1,42 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "mapped_file.hpp"
+
+namespace uni_cpp_practice {
+
+MappedFile::MappedFile(const std::string& file_path) {
+  const int file_descriptor = ::open(file_path.c_str(), O_RDONLY);
+  if (file_descriptor == -1)
+    throw std::runtime_error("Failed to open " + file_path);
+  struct stat file_status;
+  if (::fstat(file_descriptor, &file_status) == -1) {
+    ::close(file_descriptor);
+    throw std::runtime_error("Failed to stat " + file_path);
+  }
+  size_ = file_status.st_size;
+  // An empty file cannot be mapped, it is simply left without data.
+  if (size_ > 0)
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+  // The mapping keeps the file alive on its own.
+  ::close(file_descriptor);
+  if (data_ == MAP_FAILED)
+    throw std::runtime_error("Failed to map " + file_path);
+}
+
+void MappedFile::advise_sequential() const {
+  if (data_ != nullptr)
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr)
+    ::munmap(data_, size_);
+}
+
+}  // namespace uni_cpp_practice
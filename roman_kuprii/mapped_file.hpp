@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace uni_cpp_practice {
+
+// A whole file mapped read-only, pages are read on first use.
+class MappedFile {
+ public:
+  // Throws std::runtime_error if the file cannot be opened or mapped.
+  explicit MappedFile(const std::string& file_path);
+
+  const char* get_data() const { return static_cast<const char*>(data_); }
+  size_t get_size() const { return size_; }
+  std::string_view get_text() const { return {get_data(), size_}; }
+
+  // Tells the kernel the file is about to be read front to back.
+  void advise_sequential() const;
+
+  ~MappedFile();
+
+ private:
+  void* data_ = nullptr;
+  size_t size_ = 0;
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+};
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,200 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "graph.hpp"
+#include "graph_generator.hpp"
+#include "graph_printer.hpp"
+#include "logger.hpp"
+#include "random_engine.hpp"
+
+using Edge = uni_cpp_practice::Edge;
+using Graph = uni_cpp_practice::Graph;
+using GraphGenerator = uni_cpp_practice::GraphGenerator;
+using GraphPrinter = uni_cpp_practice::GraphPrinter;
+using Logger = uni_cpp_practice::Logger;
+using VertexDepth = uni_cpp_practice::VertexDepth;
+using VertexId = uni_cpp_practice::VertexId;
+
+namespace {
+// Fixed, so every run measures the same graphs.
+constexpr uint64_t SEED = 1;
+// The yellow pass compares every chosen vertex with its whole next layer,
+// graphs expected to be larger take too long to build again and again.
+constexpr double MAX_EXPECTED_VERTICES_NUM = 1 << 10;
+constexpr int IS_CONNECTED_QUERIES_NUM = 1 << 12;
+const std::string NULL_DEVICE = "/dev/null";
+
+// Every vertex at depth d has Binomial(new_vertices_num, 1 - d / depth)
+// children, as `generate_gray_branch` draws them.
+double get_expected_vertices_num(VertexDepth depth, int new_vertices_num) {
+  double layer_size = 1;
+  double vertices_num = 1;
+  for (VertexDepth current_depth = 0; current_depth < depth; current_depth++) {
+    layer_size *=
+        new_vertices_num * (1.0 - static_cast<double>(current_depth) / depth);
+    vertices_num += layer_size;
+  }
+  return vertices_num;
+}
+
+// Depths 2..14 by new_vertices_num 1..10, without the ones too large. The
+// generator works on the pool, so rates are by the wall clock.
+void add_graph_sizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"depth", "new_vertices"})->UseRealTime();
+  for (VertexDepth depth = 2; depth <= 14; depth += 3)
+    for (const int new_vertices_num : {1, 2, 4, 7, 10})
+      if (get_expected_vertices_num(depth, new_vertices_num) <=
+          MAX_EXPECTED_VERTICES_NUM)
+        benchmark->Args({depth, new_vertices_num});
+}
+
+GraphGenerator::Params get_params(const benchmark::State& state) {
+  return GraphGenerator::Params(state.range(0), state.range(1), SEED);
+}
+
+int64_t get_vertices_num(const Graph& graph) {
+  return graph.get_vertices().size();
+}
+
+int64_t get_edges_num(const Graph& graph) {
+  return graph.get_edges().size();
+}
+
+void set_graph_counters(benchmark::State& state,
+                        int64_t vertices_num,
+                        int64_t edges_num) {
+  state.counters["vertices/s"] =
+      benchmark::Counter(vertices_num, benchmark::Counter::kIsRate);
+  state.counters["edges/s"] =
+      benchmark::Counter(edges_num, benchmark::Counter::kIsRate);
+}
+
+void BM_Generate(benchmark::State& state) {
+  const GraphGenerator generator(get_params(state));
+  int graph_num = 0;
+  int64_t vertices_num = 0;
+  int64_t edges_num = 0;
+  for (auto _ : state) {
+    const Graph graph = generator.generate(graph_num++);
+    vertices_num += get_vertices_num(graph);
+    edges_num += get_edges_num(graph);
+  }
+  set_graph_counters(state, vertices_num, edges_num);
+}
+BENCHMARK(BM_Generate)->Apply(add_graph_sizes);
+
+void BM_GenerateGrayTree(benchmark::State& state) {
+  const GraphGenerator generator(get_params(state));
+  int graph_num = 0;
+  int64_t vertices_num = 0;
+  int64_t edges_num = 0;
+  for (auto _ : state) {
+    const Graph graph = generator.generate_gray_tree(graph_num++);
+    vertices_num += get_vertices_num(graph);
+    edges_num += get_edges_num(graph);
+  }
+  set_graph_counters(state, vertices_num, edges_num);
+}
+BENCHMARK(BM_GenerateGrayTree)->Apply(add_graph_sizes);
+
+// One color pass over a fresh gray tree, only the pass is timed. The edges
+// counted are the ones it added.
+template <Edge::Color color>
+void BM_PaintEdges(benchmark::State& state) {
+  const GraphGenerator generator(get_params(state));
+  std::optional<Graph> graph;
+  int graph_num = 0;
+  int64_t vertices_num = 0;
+  int64_t edges_num = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    graph.reset();
+    graph.emplace(generator.generate_gray_tree(graph_num));
+    const int64_t gray_edges_num = get_edges_num(*graph);
+    state.ResumeTiming();
+
+    generator.paint_edges(*graph, graph_num++, color);
+    vertices_num += get_vertices_num(*graph);
+    edges_num += get_edges_num(*graph) - gray_edges_num;
+  }
+  set_graph_counters(state, vertices_num, edges_num);
+}
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Green)->Apply(add_graph_sizes);
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Blue)->Apply(add_graph_sizes);
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Yellow)->Apply(add_graph_sizes);
+BENCHMARK_TEMPLATE(BM_PaintEdges, Edge::Color::Red)->Apply(add_graph_sizes);
+
+// Half of the pairs queried are edges, half are random vertices.
+void BM_IsConnected(benchmark::State& state) {
+  const Graph graph = GraphGenerator(get_params(state)).generate();
+  uni_cpp_practice::random_engine::Engine engine(SEED);
+  const int64_t vertices_num = get_vertices_num(graph);
+  const int64_t edges_num = get_edges_num(graph);
+  std::vector<std::pair<VertexId, VertexId>> pairs;
+  pairs.reserve(IS_CONNECTED_QUERIES_NUM);
+  for (int i = 0; i < IS_CONNECTED_QUERIES_NUM; i++) {
+    if (i % 2 == 0) {
+      const Edge& edge = graph.get_edges()[engine() % edges_num];
+      pairs.emplace_back(edge.source, edge.destination);
+    } else {
+      pairs.emplace_back(engine() % vertices_num, engine() % vertices_num);
+    }
+  }
+
+  for (auto _ : state)
+    for (const auto& [source, destination] : pairs)
+      benchmark::DoNotOptimize(
+          graph.are_vertices_connected(source, destination));
+  state.SetItemsProcessed(state.iterations() * pairs.size());
+}
+BENCHMARK(BM_IsConnected)->Apply(add_graph_sizes);
+
+void BM_PrintGraph(benchmark::State& state) {
+  const Graph graph = GraphGenerator(get_params(state)).generate();
+  const GraphPrinter printer(graph);
+  int64_t bytes_num = 0;
+  for (auto _ : state) {
+    const std::string json = printer.print();
+    benchmark::DoNotOptimize(json.data());
+    bytes_num += json.size();
+  }
+  state.SetBytesProcessed(bytes_num);
+  set_graph_counters(state, state.iterations() * get_vertices_num(graph),
+                     state.iterations() * get_edges_num(graph));
+}
+BENCHMARK(BM_PrintGraph)->Apply(add_graph_sizes);
+
+// Run once before the threads of a run start, and once after all of them
+// are done, so switching the output never races the records measured.
+void set_up_logger(const benchmark::State&) {
+  auto& logger = Logger::get_instance();
+  logger.set_stdout_enabled(false);
+  logger.set_file(NULL_DEVICE);
+}
+
+void tear_down_logger(const benchmark::State&) {
+  Logger::get_instance().flush();
+}
+
+// Sustained rate: once the ring is full `log` waits for the flush thread.
+void BM_LoggerLog(benchmark::State& state) {
+  auto& logger = Logger::get_instance();
+  const std::string record = "01/01/2026 12:00:00: Graph " +
+                             std::to_string(state.thread_index()) +
+                             ", Generation Started\n";
+  for (auto _ : state)
+    logger.log(record);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerLog)
+    ->Setup(set_up_logger)
+    ->Teardown(tear_down_logger)
+    ->Threads(1)
+    ->Threads(4);
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace uni_cpp_practice {
+
+// Queue of at most `capacity` values shared by producer and consumer
+// threads. A full queue blocks producers until a consumer catches up.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+  void push(T value) {
+    {
+      std::unique_lock lock(mutex_);
+      not_full_cv_.wait(lock,
+                        [this]() { return values_.size() < capacity_; });
+      values_.push_back(std::move(value));
+    }
+    not_empty_cv_.notify_one();
+  }
+
+  // Blocks until there is a value. Returns std::nullopt once the queue is
+  // closed and drained.
+  std::optional<T> pop() {
+    std::optional<T> value;
+    {
+      std::unique_lock lock(mutex_);
+      not_empty_cv_.wait(lock,
+                         [this]() { return !values_.empty() || is_closed_; });
+      if (values_.empty()) {
+        return std::nullopt;
+      }
+      value = std::move(values_.front());
+      values_.pop_front();
+    }
+    not_full_cv_.notify_one();
+    return value;
+  }
+
+  // No more values will be pushed, wakes up the consumers.
+  void close() {
+    {
+      const std::lock_guard lock(mutex_);
+      is_closed_ = true;
+    }
+    not_empty_cv_.notify_all();
+  }
+
+ private:
+  const size_t capacity_;
+  std::deque<T> values_;
+  std::mutex mutex_;
+  std::condition_variable not_full_cv_;
+  std::condition_variable not_empty_cv_;
+  bool is_closed_ = false;
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+};
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,158 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "graph_archive.hpp"
+#include "graph_generator.hpp"
+#include "graph_printer.hpp"
+
+using GraphArchiveReader = uni_cpp_practice::GraphArchiveReader;
+using GraphArchiveWriter = uni_cpp_practice::GraphArchiveWriter;
+using GraphGenerator = uni_cpp_practice::GraphGenerator;
+using GraphPrinter = uni_cpp_practice::GraphPrinter;
+
+namespace {
+// Fixed, so a failure can be replayed.
+constexpr uint64_t SEED = 1;
+constexpr int ENTRY_SIZE = 40;
+constexpr int TRAILER_SIZE = 24;
+const std::string ARCHIVE_FILENAME = "./temp/check.archive";
+
+void expect(bool condition, const std::string& what) {
+  if (!condition)
+    throw std::runtime_error("Check failed: " + what);
+}
+
+template <typename Exception, typename Callback>
+void expect_throws(const Callback& callback, const std::string& what) {
+  try {
+    callback();
+  } catch (const Exception&) {
+    return;
+  }
+  throw std::runtime_error("Check failed, nothing thrown: " + what);
+}
+
+std::string read_file(const std::string& filename) {
+  std::ifstream file(filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+void write_file(const std::string& filename, const std::string& bytes) {
+  std::ofstream file(filename, std::ios::binary);
+  file << bytes;
+}
+
+// Graphs are written out of order and with two sets of params.
+void check_archive_round_trip() {
+  const std::vector<GraphGenerator::Params> params = {
+      GraphGenerator::Params(4, 3, SEED), GraphGenerator::Params(6, 4, SEED)};
+  const std::vector<std::pair<int, int>> graphs = {
+      {3, 0}, {0, 0}, {5, 1}, {1, 0}, {4, 1}, {2, 0}};
+
+  std::vector<std::string> expected_jsons(graphs.size());
+  GraphArchiveWriter writer(ARCHIVE_FILENAME);
+  for (const auto& [graph_number, params_index] : graphs) {
+    const auto graph =
+        GraphGenerator(params[params_index]).generate(graph_number);
+    expected_jsons[graph_number] = GraphPrinter(graph).print();
+    writer.write_graph(expected_jsons[graph_number], graph_number,
+                       params[params_index]);
+  }
+  writer.close();
+
+  GraphArchiveReader reader(ARCHIVE_FILENAME);
+  expect(reader.graphs_count() == (int)graphs.size(), "archive graphs count");
+  for (const auto& [graph_number, params_index] : graphs) {
+    const auto& entry = reader.get_entries()[graph_number];
+    const auto& graph_params = params[params_index];
+    expect(entry.graph_number == graph_number, "archive entries are sorted");
+    expect(entry.seed == graph_params.seed &&
+               entry.max_depth == graph_params.max_depth &&
+               entry.new_vertices_num == graph_params.new_vertices_num,
+           "archive entry params");
+    expect(reader.read_graph(graph_number) == expected_jsons[graph_number],
+           "archived graph " + std::to_string(graph_number) + " bytes");
+  }
+  expect_throws<std::out_of_range>(
+      [&reader, &graphs]() { reader.read_graph(graphs.size()); },
+      "reading a graph the archive does not have");
+}
+
+void check_archive_index() {
+  {
+    GraphArchiveWriter writer(ARCHIVE_FILENAME);
+    writer.close();
+  }
+  expect(GraphArchiveReader(ARCHIVE_FILENAME).graphs_count() == 0,
+         "empty archive");
+
+  {
+    const auto params = GraphGenerator::Params(3, 2, SEED);
+    GraphArchiveWriter writer(ARCHIVE_FILENAME);
+    for (int graph_number = 0; graph_number < 2; graph_number++) {
+      const auto graph = GraphGenerator(params).generate(graph_number);
+      writer.write_graph(GraphPrinter(graph).print(), graph_number, params);
+    }
+    writer.close();
+  }
+  const auto archive = read_file(ARCHIVE_FILENAME);
+  const auto expect_rejected = [](const std::string& bytes,
+                                  const std::string& what) {
+    write_file(ARCHIVE_FILENAME, bytes);
+    expect_throws<std::runtime_error>(
+        []() { GraphArchiveReader{ARCHIVE_FILENAME}; }, what);
+  };
+  const auto with_integer = [&archive](size_t offset, uint64_t value) {
+    auto bytes = archive;
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+    return bytes;
+  };
+  expect_rejected(archive.substr(0, archive.size() - 1), "truncated trailer");
+  expect_rejected(archive.substr(0, 8), "archive without an index");
+  auto wrong_magic = archive;
+  wrong_magic.back() = '?';
+  expect_rejected(wrong_magic, "trailer without the magic");
+
+  // The trailer is the index offset, the graphs count and the magic.
+  const size_t graphs_count_offset = archive.size() - 16;
+  const size_t index_offset = archive.size() - TRAILER_SIZE - 2 * ENTRY_SIZE;
+  expect_rejected(with_integer(graphs_count_offset, 3),
+                  "graphs count beyond the index");
+  // Times the entry size, it wraps around to the size of the two entries.
+  expect_rejected(with_integer(graphs_count_offset, (uint64_t{1} << 61) + 2),
+                  "graphs count overflowing the index size");
+  expect_rejected(with_integer(archive.size() - TRAILER_SIZE, 0),
+                  "index offset inside the leading magic");
+  // An entry is the offset, the length and the seed, then the graph number.
+  expect_rejected(with_integer(index_offset, 0),
+                  "graph inside the leading magic");
+  expect_rejected(with_integer(index_offset + 8, UINT64_MAX),
+                  "graph length beyond the index");
+  expect_rejected(with_integer(index_offset + ENTRY_SIZE, index_offset + 1),
+                  "graph starting beyond the index");
+  auto repeated_graph_number = archive;
+  repeated_graph_number[index_offset + ENTRY_SIZE + 24] = 0;
+  expect_rejected(repeated_graph_number, "repeated graph number");
+}
+}  // namespace
+
+// Round trips of the graph archive, `make check` runs them.
+int main() {
+  std::filesystem::create_directory("./temp");
+  try {
+    check_archive_round_trip();
+    check_archive_index();
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
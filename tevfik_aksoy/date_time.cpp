@@ -0,0 +1,57 @@
+#include "date_time.hpp"
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <ctime>
+#include <string>
+
+namespace {
+
+constexpr size_t DATE_TIME_LENGTH = 19;
+
+// "DD/MM/YYYY HH:MM:SS" of the second it was last formatted for.
+struct SecondPrefix {
+  std::time_t second = -1;
+  std::array<char, DATE_TIME_LENGTH + 1> text;
+};
+
+const SecondPrefix& get_second_prefix(std::time_t second) {
+  thread_local SecondPrefix prefix;
+  if (prefix.second != second) {
+    std::tm local_date_time;
+    localtime_r(&second, &local_date_time);
+    std::strftime(prefix.text.data(), prefix.text.size(), "%d/%m/%Y %T",
+                  &local_date_time);
+    prefix.second = second;
+  }
+  return prefix;
+}
+
+}  // namespace
+
+namespace uni_cpp_practice {
+
+namespace date_time {
+
+void append_date_time(std::string& text) {
+  const auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+  const auto seconds =
+      std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+  const int milliseconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch -
+                                                            seconds)
+          .count();
+
+  text.append(get_second_prefix(seconds.count()).text.data(),
+              DATE_TIME_LENGTH);
+  // Printing 1000 + ms and replacing the leading 1 keeps the zero padding.
+  std::array<char, 4> digits;
+  std::to_chars(digits.data(), digits.data() + digits.size(),
+                1000 + milliseconds);
+  digits[0] = '.';
+  text.append(digits.data(), digits.size());
+}
+
+}  // namespace date_time
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+namespace uni_cpp_practice {
+
+namespace date_time {
+
+// Appends the local time as "DD/MM/YYYY HH:MM:SS.mmm". Every thread keeps
+// the text of the current second and only formats the milliseconds, so
+// this neither allocates nor touches shared state.
+void append_date_time(std::string& text);
+
+}  // namespace date_time
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,145 @@
+#include "graph_archive.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+using GraphArchiveEntry = uni_cpp_practice::GraphArchiveEntry;
+
+constexpr std::string_view MAGIC = "GRAPHARC";
+constexpr int ENTRY_SIZE = 40;
+constexpr int TRAILER_SIZE = 24;
+
+void append_integer(std::string& bytes, uint64_t value, int size) {
+  for (int i = 0; i < size; i++)
+    bytes.push_back((char)(value >> (8 * i)));
+}
+
+uint64_t read_integer(const char* bytes, int size) {
+  uint64_t value = 0;
+  for (int i = 0; i < size; i++)
+    value |= (uint64_t)(unsigned char)bytes[i] << (8 * i);
+  return value;
+}
+
+GraphArchiveEntry read_entry(const char* bytes) {
+  GraphArchiveEntry entry;
+  entry.offset = read_integer(bytes, 8);
+  entry.length = read_integer(bytes + 8, 8);
+  entry.seed = read_integer(bytes + 16, 8);
+  entry.graph_number = (int)read_integer(bytes + 24, 4);
+  entry.max_depth = (int)read_integer(bytes + 28, 4);
+  entry.new_vertices_num = (int)read_integer(bytes + 32, 4);
+  entry.flags = (int)read_integer(bytes + 36, 4);
+  return entry;
+}
+}  // namespace
+
+namespace uni_cpp_practice {
+
+GraphArchiveWriter::GraphArchiveWriter(const std::string& filename)
+    : file_stream_(filename, std::ios::out | std::ios::binary) {
+  if (!file_stream_.is_open())
+    throw std::runtime_error("Error while opening the graph archive!");
+  file_stream_ << MAGIC;
+  size_ = MAGIC.size();
+}
+
+void GraphArchiveWriter::write_graph(const std::string& graph_json,
+                                     int graph_number,
+                                     const GraphGenerator::Params& params) {
+  GraphArchiveEntry entry;
+  entry.offset = size_;
+  entry.length = graph_json.size();
+  entry.seed = params.seed;
+  entry.graph_number = graph_number;
+  entry.max_depth = params.max_depth;
+  entry.new_vertices_num = params.new_vertices_num;
+  file_stream_ << graph_json;
+  size_ += graph_json.size();
+  entries_.push_back(entry);
+}
+
+void GraphArchiveWriter::close() {
+  std::sort(entries_.begin(), entries_.end(),
+            [](const GraphArchiveEntry& lhs, const GraphArchiveEntry& rhs) {
+              return lhs.graph_number < rhs.graph_number;
+            });
+  std::string index;
+  for (const auto& entry : entries_) {
+    append_integer(index, entry.offset, 8);
+    append_integer(index, entry.length, 8);
+    append_integer(index, entry.seed, 8);
+    append_integer(index, (uint32_t)entry.graph_number, 4);
+    append_integer(index, (uint32_t)entry.max_depth, 4);
+    append_integer(index, (uint32_t)entry.new_vertices_num, 4);
+    append_integer(index, (uint32_t)entry.flags, 4);
+  }
+  append_integer(index, size_, 8);
+  append_integer(index, entries_.size(), 8);
+  index += MAGIC;
+  file_stream_ << index;
+  file_stream_.close();
+  if (file_stream_.fail())
+    throw std::runtime_error("Error while writing the graph archive!");
+}
+
+GraphArchiveReader::GraphArchiveReader(const std::string& filename)
+    : file_stream_(filename, std::ios::in | std::ios::binary) {
+  if (!file_stream_.is_open())
+    throw std::runtime_error("Error while opening the graph archive!");
+  file_stream_.seekg(0, std::ios::end);
+  const uint64_t file_size = file_stream_.tellg();
+  if (file_size < MAGIC.size() + TRAILER_SIZE)
+    throw std::runtime_error("Not a graph archive!");
+
+  char trailer[TRAILER_SIZE];
+  file_stream_.seekg(file_size - TRAILER_SIZE);
+  file_stream_.read(trailer, TRAILER_SIZE);
+  const uint64_t index_offset = read_integer(trailer, 8);
+  const uint64_t graphs_count = read_integer(trailer + 8, 8);
+  // Divided instead of multiplied, so a broken graphs count can not overflow
+  // into the right index size.
+  const uint64_t index_end = file_size - TRAILER_SIZE;
+  if (!file_stream_ ||
+      std::string_view(trailer + 16, MAGIC.size()) != MAGIC ||
+      index_offset < MAGIC.size() || index_offset > index_end ||
+      (index_end - index_offset) % ENTRY_SIZE != 0 ||
+      (index_end - index_offset) / ENTRY_SIZE != graphs_count)
+    throw std::runtime_error("Not a graph archive!");
+
+  std::string index(index_end - index_offset, '\0');
+  file_stream_.seekg(index_offset);
+  file_stream_.read(index.data(), index.size());
+  if (!file_stream_)
+    throw std::runtime_error("Error while reading the graph archive!");
+  entries_.reserve(graphs_count);
+  for (uint64_t i = 0; i < graphs_count; i++) {
+    const auto entry = read_entry(index.data() + i * ENTRY_SIZE);
+    // Graphs lie between the leading magic and the index.
+    if (entry.offset < MAGIC.size() || entry.offset > index_offset ||
+        entry.length > index_offset - entry.offset)
+      throw std::runtime_error("Graph is outside of the archive!");
+    if (!entries_.empty() &&
+        entries_.back().graph_number >= entry.graph_number)
+      throw std::runtime_error("Graph numbers are not sorted and unique!");
+    entries_.push_back(entry);
+  }
+}
+
+std::string GraphArchiveReader::read_graph(int graph_number) {
+  const auto entry = std::lower_bound(
+      entries_.begin(), entries_.end(), graph_number,
+      [](const GraphArchiveEntry& entry, int number) {
+        return entry.graph_number < number;
+      });
+  if (entry == entries_.end() || entry->graph_number != graph_number)
+    throw std::out_of_range("No such graph in the archive!");
+  std::string graph_json(entry->length, '\0');
+  file_stream_.seekg(entry->offset);
+  file_stream_.read(graph_json.data(), graph_json.size());
+  if (!file_stream_)
+    throw std::runtime_error("Error while reading the graph archive!");
+  return graph_json;
+}
+}  // namespace uni_cpp_practice
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "graph_generator.hpp"
+
+namespace uni_cpp_practice {
+
+// All the graphs of a run in one file: their JSON back to back, then an
+// index of 40 byte entries sorted by graph number (offset, length, seed as
+// u64, graph number, depth, new_vertices_num, flags as i32), then the index
+// offset and the graphs count as u64 and "GRAPHARC". Integers are little
+// endian, the file also starts with "GRAPHARC".
+struct GraphArchiveEntry {
+  uint64_t offset = 0;
+  uint64_t length = 0;
+  uint64_t seed = 0;
+  int graph_number = 0;
+  int max_depth = 0;
+  int new_vertices_num = 0;
+  int flags = 0;
+};
+
+class GraphArchiveWriter {
+ public:
+  explicit GraphArchiveWriter(const std::string& filename);
+
+  void write_graph(const std::string& graph_json,
+                   int graph_number,
+                   const GraphGenerator::Params& params);
+
+  // Writes the index, the archive can not be read without it.
+  void close();
+
+ private:
+  std::ofstream file_stream_;
+  uint64_t size_ = 0;
+  std::vector<GraphArchiveEntry> entries_;
+};
+
+class GraphArchiveReader {
+ public:
+  explicit GraphArchiveReader(const std::string& filename);
+
+  int graphs_count() const { return entries_.size(); }
+  const std::vector<GraphArchiveEntry>& get_entries() const {
+    return entries_;
+  }
+
+  // Reads the JSON of one graph without touching the others.
+  std::string read_graph(int graph_number);
+
+ private:
+  std::ifstream file_stream_;
+  std::vector<GraphArchiveEntry> entries_;
+};
+}  // namespace uni_cpp_practice
@@ -1,215 +1,236 @@
 #include "graph_generator.hpp"
-#include <array>
-#include <atomic>
-#include <functional>
 #include <iostream>
-#include <list>
 #include <random>
-#include <thread>
+#include <utility>
+#include <vector>
+#include "random_engine.hpp"
+#include "thread_pool.hpp"
 
 using VertexId = uni_cpp_practice::VertexId;
 using Graph = uni_cpp_practice::Graph;
+using Engine = uni_cpp_practice::random_engine::Engine;
 
-constexpr int MAX_THREADS_COUNT = 4;
+constexpr int BRANCH_ROOT_INDEX = -1;
 
 namespace {
 constexpr float GREEN_EDGE_PROBABILITY = 0.1;
 constexpr float BLUE_EDGE_PROBABILITY = 0.25;
 constexpr float RED_EDGE_PROBABILITY = 0.33;
 
-float get_random_probability() {
-  std::random_device rd;
-  std::mt19937 mt(rd());
+float get_random_probability(Engine& engine) {
   std::uniform_real_distribution<float> probability(0.0, 1);
-  return probability(mt);
+  return probability(engine);
 }
 
-VertexId get_random_vertex_id(const std::vector<VertexId>& vertices) {
-  std::random_device rd;
-  std::mt19937 mt(rd());
+// Calls `on_success(i)` for every `i` in `[first, last)` whose trial with
+// `probability` succeeds. The gaps between successes are geometric, so one
+// draw per success gives the same edges as one draw per vertex.
+template <typename OnSuccess>
+void for_each_success(VertexId first,
+                      VertexId last,
+                      float probability,
+                      Engine& engine,
+                      const OnSuccess& on_success) {
+  std::geometric_distribution<VertexId> gap(probability);
+  for (VertexId i = first + gap(engine); i < last; i += 1 + gap(engine)) {
+    on_success(i);
+  }
+}
+
+VertexId get_random_vertex_id(const std::vector<VertexId>& vertices,
+                              Engine& engine) {
   std::uniform_int_distribution<int> random_vertex_distribution(
       0, vertices.size() - 1);
-  return vertices[random_vertex_distribution(mt)];
+  return vertices[random_vertex_distribution(engine)];
 }
 
 std::vector<VertexId> filter_connected_vertices(
     const VertexId& vertex_id,
     const std::vector<VertexId>& next_vertices,
-    const Graph& graph,
-    std::mutex& mutex) {
+    const Graph& graph) {
   std::vector<VertexId> filtered_vertices;
   for (const auto& next_vertex_id : next_vertices) {
-    const auto is_connected = [&graph, &mutex, vertex_id, &next_vertex_id]() {
-      const std::lock_guard lock(mutex);
-      return graph.are_vertices_connected(vertex_id, next_vertex_id);
-    }();
-    if (!is_connected) {
+    if (!graph.are_vertices_connected(vertex_id, next_vertex_id)) {
       filtered_vertices.push_back(next_vertex_id);
     }
   }
   return filtered_vertices;
 }
+
+// Edges found by one job, inserted into the graph after all jobs finish.
+using EdgeCandidates = std::vector<std::pair<VertexId, VertexId>>;
 }  // namespace
 
 namespace uni_cpp_practice {
 
-void GraphGenerator::generate_gray_branch(Graph& graph,
-                                          std::mutex& mutex,
-                                          const VertexId& source_vertex_id,
-                                          VertexDepth depth) const {
-  const auto new_vertex_id = [&graph, &mutex, &source_vertex_id]() {
-    const std::lock_guard lock(mutex);
-    const auto& new_vertex_id = graph.insert_vertex();
-    graph.insert_edge(source_vertex_id, new_vertex_id);
-    return new_vertex_id;
-  }();
+void GraphGenerator::generate_gray_branch(std::vector<int>& parent_indices,
+                                          int parent_index,
+                                          VertexDepth depth,
+                                          Engine& engine) const {
+  const int new_vertex_index = parent_indices.size();
+  parent_indices.push_back(parent_index);
   if (depth == params_.max_depth) {
     return;
   }
   const float probability = (float)depth / (float)params_.max_depth;
   for (int i = 0; i < params_.new_vertices_num; ++i) {
-    if (get_random_probability() > probability) {
-      generate_gray_branch(graph, mutex, new_vertex_id, depth + 1);
+    if (get_random_probability(engine) > probability) {
+      generate_gray_branch(parent_indices, new_vertex_index, depth + 1,
+                           engine);
     }
   }
 }
+
 void GraphGenerator::generate_vertices_and_gray_edges(
     Graph& graph,
-    const VertexId& source_vertex_id) const {
-  using JobCallback = std::function<void()>;
-  auto jobs = std::list<JobCallback>();
-  std::atomic<bool> should_terminate = false;
-  std::atomic<int> jobs_count = 0;
-  std::mutex graph_mutex;
-
-  for (int i = 0; i < params_.new_vertices_num; i++) {
-    jobs.emplace_back(
-        [this, &graph, &graph_mutex, &jobs_count, &source_vertex_id]() {
-          generate_gray_branch(graph, graph_mutex, source_vertex_id, 1);
-          ++jobs_count;
-        });
+    const VertexId& source_vertex_id,
+    uint64_t graph_seed) const {
+  const int branches_count = params_.new_vertices_num;
+  std::vector<std::vector<int>> branches(branches_count);
+  TaskGroup branch_jobs;
+  for (int i = 0; i < branches_count; ++i) {
+    branch_jobs.run([this, &branch = branches[i], graph_seed, i]() {
+      Engine engine(graph_seed, i);
+      generate_gray_branch(branch, BRANCH_ROOT_INDEX, 1, engine);
+    });
   }
-
-  std::mutex jobs_mutex;
-  const auto worker = [&should_terminate, &jobs_mutex, &jobs]() {
-    while (true) {
-      if (should_terminate) {
-        return;
-      }
-      const auto job_optional = [&jobs_mutex,
-                                 &jobs]() -> std::optional<JobCallback> {
-        const std::lock_guard lock(jobs_mutex);
-        if (jobs.empty()) {
-          return std::nullopt;
-        }
-        const auto first_job = jobs.front();
-        jobs.pop_front();
-        return first_job;
-      }();
-      if (job_optional.has_value()) {
-        const auto& job = job_optional.value();
-        job();
-      }
+  branch_jobs.wait();
+
+  // Splice the branches in order, mapping branch indices to vertex ids.
+  for (const auto& parent_indices : branches) {
+    std::vector<VertexId> branch_vertex_ids;
+    branch_vertex_ids.reserve(parent_indices.size());
+    for (const auto parent_index : parent_indices) {
+      const auto new_vertex_id = graph.insert_vertex();
+      graph.insert_edge(parent_index == BRANCH_ROOT_INDEX
+                            ? source_vertex_id
+                            : branch_vertex_ids[parent_index],
+                        new_vertex_id);
+      branch_vertex_ids.push_back(new_vertex_id);
     }
-  };
-
-  const auto threads_count =
-      std::max(MAX_THREADS_COUNT, params_.new_vertices_num);
-  auto threads = std::vector<std::thread>();
-  threads.reserve(threads_count);
-
-  for (int i = 0; i < threads_count; ++i) {
-    threads.push_back(std::thread(worker));
-  }
-
-  while (jobs_count < params_.new_vertices_num) {
   }
+}
 
-  should_terminate = true;
-  for (auto& thread : threads) {
-    thread.join();
-  }
+void generate_green_edges(const Graph& graph,
+                          VertexDepth depth,
+                          Engine& engine,
+                          EdgeCandidates& candidates) {
+  const auto& vertices_in_depth = graph.get_vertices_in_depth(depth);
+  for_each_success(0, vertices_in_depth.size(), GREEN_EDGE_PROBABILITY, engine,
+                   [&vertices_in_depth, &candidates](VertexId j) {
+                     candidates.emplace_back(vertices_in_depth[j],
+                                             vertices_in_depth[j]);
+                   });
 }
 
-void generate_green_edges(Graph& graph, std::mutex& mutex) {
-  for (const auto& vertex : graph.get_vertices()) {
-    if (get_random_probability() < GREEN_EDGE_PROBABILITY) {
-      const std::lock_guard lock(mutex);
-      graph.insert_edge(vertex.id, vertex.id);
-    }
-  }
+void generate_blue_edges(const Graph& graph,
+                         VertexDepth depth,
+                         Engine& engine,
+                         EdgeCandidates& candidates) {
+  const auto& vertices_in_depth = graph.get_vertices_in_depth(depth);
+  for_each_success(0, (VertexId)vertices_in_depth.size() - 1,
+                   BLUE_EDGE_PROBABILITY, engine,
+                   [&vertices_in_depth, &candidates](VertexId j) {
+                     candidates.emplace_back(vertices_in_depth[j],
+                                             vertices_in_depth[j + 1]);
+                   });
 }
 
-void generate_blue_edges(Graph& graph, std::mutex& mutex) {
-  for (int depth = 0; depth < graph.depth(); depth++) {
-    const auto& vertices_in_depth = graph.get_vertices_in_depth(depth);
-    for (VertexId j = 0; j < vertices_in_depth.size() - 1; j++) {
-      if (get_random_probability() < BLUE_EDGE_PROBABILITY) {
-        const auto source = vertices_in_depth[j];
-        const auto destination = vertices_in_depth[j + 1];
-        const std::lock_guard lock(mutex);
-        graph.insert_edge(source, destination);
+// Jobs only read the graph, which holds nothing but gray edges until the
+// candidates are inserted.
+void generate_yellow_edges(const Graph& graph,
+                           VertexDepth depth,
+                           Engine& engine,
+                           EdgeCandidates& candidates) {
+  const auto& vertices = graph.get_vertices_in_depth(depth);
+  const auto& vertices_next = graph.get_vertices_in_depth(depth + 1);
+  float probability = 1 - (float)depth * (1 / (float)(graph.depth() - 1));
+  for (const auto& vertex_id : vertices) {
+    if (get_random_probability(engine) > probability) {
+      std::vector<VertexId> filtered_vertex_ids;
+      filtered_vertex_ids =
+          filter_connected_vertices(vertex_id, vertices_next, graph);
+      if (!filtered_vertex_ids.empty()) {
+        candidates.emplace_back(
+            vertex_id, get_random_vertex_id(filtered_vertex_ids, engine));
       }
     }
   }
 }
 
-void generate_yellow_edges(Graph& graph, std::mutex& mutex) {
-  for (VertexDepth depth = 1; depth < graph.depth(); depth++) {
-    const auto& vertices = graph.get_vertices_in_depth(depth);
-    const auto& vertices_next = graph.get_vertices_in_depth(depth + 1);
-    float probability = 1 - (float)depth * (1 / (float)(graph.depth() - 1));
-    for (const auto& vertex_id : vertices) {
-      if (get_random_probability() > probability) {
-        std::vector<VertexId> filtered_vertex_ids;
-        filtered_vertex_ids =
-            filter_connected_vertices(vertex_id, vertices_next, graph, mutex);
-        if (!filtered_vertex_ids.empty()) {
-          VertexId random_vertex_id = get_random_vertex_id(filtered_vertex_ids);
-          const std::lock_guard lock(mutex);
-          graph.insert_edge(vertex_id, random_vertex_id);
-        }
-      }
-    }
-  }
+void generate_red_edges(const Graph& graph,
+                        VertexDepth depth,
+                        Engine& engine,
+                        EdgeCandidates& candidates) {
+  const auto& vertices = graph.get_vertices_in_depth(depth);
+  const auto& vertices_next = graph.get_vertices_in_depth(depth + 2);
+  for_each_success(
+      0, vertices.size(), RED_EDGE_PROBABILITY, engine,
+      [&vertices, &vertices_next, &engine, &candidates](VertexId j) {
+        candidates.emplace_back(vertices[j],
+                                get_random_vertex_id(vertices_next, engine));
+      });
 }
 
-void generate_red_edges(Graph& graph, std::mutex& mutex) {
-  for (VertexDepth depth = 0; depth < graph.depth() - 1; depth++) {
-    const auto& vertices = graph.get_vertices_in_depth(depth);
-    const auto& vertices_next = graph.get_vertices_in_depth(depth + 2);
-    for (const auto& vertex : vertices) {
-      if (get_random_probability() < RED_EDGE_PROBABILITY) {
-        const std::lock_guard lock(mutex);
-        graph.insert_edge(vertex, get_random_vertex_id(vertices_next));
-      }
-    }
-  }
+Graph GraphGenerator::generate(int graph_num) const {
+  Graph graph = generate_gray_tree(graph_num);
+  paint_edges(graph, graph_num);
+  return graph;
 }
 
-Graph GraphGenerator::generate() const {
+Graph GraphGenerator::generate_gray_tree(int graph_num) const {
   Graph graph;
   const auto vertex_zero = graph.insert_vertex();
 
-  std::mutex mutex;
-
-  generate_vertices_and_gray_edges(graph, vertex_zero);
-  std::thread green_thread(generate_green_edges, std::ref(graph),
-                           std::ref(mutex));
-
-  std::thread blue_thread(generate_blue_edges, std::ref(graph),
-                          std::ref(mutex));
-
-  std::thread yellow_thread(generate_yellow_edges, std::ref(graph),
-                            std::ref(mutex));
-
-  std::thread red_thread(generate_red_edges, std::ref(graph), std::ref(mutex));
-
-  green_thread.join();
-  blue_thread.join();
-  yellow_thread.join();
-  red_thread.join();
-
+  generate_vertices_and_gray_edges(graph, vertex_zero,
+                                   get_graph_seed(graph_num));
   return graph;
 }
+
+void GraphGenerator::paint_edges(
+    Graph& graph,
+    int graph_num,
+    const std::optional<Edge::Color>& only_color) const {
+  // One job per color and depth, each filling its own buffer, so the colors
+  // scale with the graph width instead of sharing one mutex. Jobs draw from
+  // the streams after the branches', in the order they are queued; skipped
+  // colors still use up their streams.
+  const uint64_t graph_seed = get_graph_seed(graph_num);
+  const VertexDepth graph_depth = graph.depth();
+  uint64_t next_stream = params_.new_vertices_num;
+  std::vector<EdgeCandidates> candidates;
+  candidates.reserve(4 * (graph_depth + 1));
+  TaskGroup color_jobs;
+  const auto run_color_jobs = [&graph, &candidates, &color_jobs, &only_color,
+                               &next_stream, graph_seed](
+                                  Edge::Color color, VertexDepth first_depth,
+                                  VertexDepth last_depth,
+                                  auto generate_edges) {
+    for (VertexDepth depth = first_depth; depth <= last_depth; depth++) {
+      const uint64_t stream = next_stream++;
+      if (only_color.has_value() && only_color.value() != color)
+        continue;
+      auto& depth_candidates = candidates.emplace_back();
+      color_jobs.run([&graph, &depth_candidates, depth, generate_edges,
+                      graph_seed, stream]() {
+        Engine engine(graph_seed, stream);
+        generate_edges(graph, depth, engine, depth_candidates);
+      });
+    }
+  };
+  run_color_jobs(Edge::Color::Green, 0, graph_depth, generate_green_edges);
+  run_color_jobs(Edge::Color::Blue, 0, graph_depth - 1, generate_blue_edges);
+  run_color_jobs(Edge::Color::Yellow, 1, graph_depth - 1,
+                 generate_yellow_edges);
+  run_color_jobs(Edge::Color::Red, 0, graph_depth - 2, generate_red_edges);
+  color_jobs.wait();
+
+  for (const auto& depth_candidates : candidates) {
+    for (const auto& [source, destination] : depth_candidates) {
+      if (!graph.are_vertices_connected(source, destination)) {
+        graph.insert_edge(source, destination);
+      }
+    }
+  }
+}
 }  // namespace uni_cpp_practice
@@ -1,31 +1,58 @@
 #pragma once
 
-#include <mutex>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
 #include "graph.hpp"
+#include "random_engine.hpp"
 
 namespace uni_cpp_practice {
 
 class GraphGenerator {
  public:
   struct Params {
-    explicit Params(int depth = 0, int _new_vertices_num = 0)
-        : max_depth(depth), new_vertices_num(_new_vertices_num) {}
+    explicit Params(int depth = 0,
+                    int _new_vertices_num = 0,
+                    uint64_t _seed = std::random_device{}())
+        : max_depth(depth), new_vertices_num(_new_vertices_num), seed(_seed) {}
 
     const int max_depth = 0;
     const int new_vertices_num = 0;
+    // Graphs generated with the same params and `graph_num` are the same,
+    // whichever threads their jobs run on.
+    const uint64_t seed = 0;
   };
 
   explicit GraphGenerator(const Params& params = Params()) : params_(params) {}
 
-  Graph generate() const;
+  Graph generate(int graph_num = 0) const;
+
+  // The two stages of `generate` on their own, so they can be measured: the
+  // gray tree, then the colored edges on top of it. With `only_color` set
+  // just that color is painted, with the same edges `generate` would give.
+  Graph generate_gray_tree(int graph_num = 0) const;
+  void paint_edges(
+      Graph& graph,
+      int graph_num = 0,
+      const std::optional<Edge::Color>& only_color = std::nullopt) const;
 
  private:
+  using Engine = random_engine::Engine;
+
   const Params params_ = Params();
+  uint64_t get_graph_seed(int graph_num) const {
+    return random_engine::mix_seed(params_.seed, graph_num);
+  }
+  // Branch `i` draws from stream `i` of `graph_seed`.
   void generate_vertices_and_gray_edges(Graph& graph,
-                                        const VertexId& source_vertex_id) const;
-  void generate_gray_branch(Graph& graph,
-                            std::mutex& mutex,
-                            const VertexId& source_vertex_id,
-                            VertexDepth depth) const;
+                                        const VertexId& source_vertex_id,
+                                        uint64_t graph_seed) const;
+  // Builds a branch without touching the graph: parent_indices[i] is the
+  // index of the parent of the i-th vertex inside the branch.
+  void generate_gray_branch(std::vector<int>& parent_indices,
+                            int parent_index,
+                            VertexDepth depth,
+                            Engine& engine) const;
 };
 }  // namespace uni_cpp_practice
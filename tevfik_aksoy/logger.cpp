@@ -1,38 +1,187 @@
 #include "logger.hpp"
-#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace {
+
+// The flush thread writes once it has this much or the ring is empty.
+constexpr size_t BATCH_SIZE = 1 << 16;
+
+// Upper bound on how long a record can wait if a wake up is missed.
+constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(20);
+
+void write_all(int file_descriptor, const std::string& text) {
+  const char* data = text.data();
+  size_t size = text.size();
+  while (size > 0) {
+    const ssize_t written = ::write(file_descriptor, data, size);
+    if (written == -1) {
+      if (errno == EINTR)
+        continue;
+      return;
+    }
+    data += written;
+    size -= written;
+  }
+}
+
+}  // namespace
 
 namespace uni_cpp_practice {
+
+Logger::Logger() {
+  for (size_t i = 0; i < RING_SIZE; i++)
+    ring_[i].sequence.store(i, std::memory_order_relaxed);
+  flush_thread_ = std::thread([this]() { run_flush_thread(); });
+}
+
 void Logger::set_file(const std::optional<std::string>& filename) {
-  if (!filename.has_value()) {
-    if (file_stream_.has_value()) {
-      file_stream_->close();
-      file_stream_ = std::nullopt;
-    }
+  flush();
+  const std::lock_guard lock(output_mutex_);
+  if (file_descriptor_ != -1) {
+    ::close(file_descriptor_);
+    file_descriptor_ = -1;
+  }
+  if (!filename.has_value())
     return;
+
+  file_descriptor_ =
+      ::open(filename->c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (file_descriptor_ == -1)
+    throw std::runtime_error("Error while opening the log file!");
+}
+
+void Logger::log(std::string string) {
+  while (!try_enqueue(string)) {
+    if (overflow_policy_.load(std::memory_order_relaxed) ==
+        OverflowPolicy::Drop) {
+      dropped_records_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    wake_flush_thread();
+    std::this_thread::yield();
   }
+  if (is_flush_thread_sleeping_.load())
+    wake_flush_thread();
+}
 
-  if (file_stream_.has_value()) {
-    file_stream_->close();
+bool Logger::try_enqueue(std::string& text) {
+  uint64_t position = enqueue_position_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = ring_[position % RING_SIZE];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence == position) {
+      if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+        slot.text = std::move(text);
+        // Sequentially consistent, so it cannot pass the check of
+        // `is_flush_thread_sleeping_` that follows in `log`.
+        slot.sequence.store(position + 1);
+        return true;
+      }
+    } else if (sequence < position) {
+      // The slot still holds a record from the previous lap.
+      return false;
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
   }
+}
 
-  file_stream_ = std::ofstream(filename.value());
-  if (!file_stream_->is_open())
-    throw std::runtime_error("Error while opening the log file!");
+bool Logger::try_dequeue(std::string& text) {
+  Slot& slot = ring_[dequeue_position_ % RING_SIZE];
+  if (slot.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1)
+    return false;
+  text = std::move(slot.text);
+  slot.sequence.store(dequeue_position_ + RING_SIZE,
+                      std::memory_order_release);
+  dequeue_position_++;
+  return true;
+}
+
+void Logger::wake_flush_thread() {
+  {
+    const std::lock_guard lock(flush_mutex_);
+  }
+  flush_cv_.notify_one();
 }
 
-void Logger::log(const std::string& string) {
-  const std::lock_guard lock(mutex_);
-  if (file_stream_.has_value())
-    file_stream_.value() << string;
-  std::cout << string;
+void Logger::flush() {
+  const uint64_t position = enqueue_position_.load();
+  wake_flush_thread();
+  std::unique_lock lock(flush_mutex_);
+  written_cv_.wait(
+      lock, [this, position]() { return written_position_ >= position; });
 }
 
-Logger::~Logger() {
-  if (file_stream_.has_value())
-    if (file_stream_->is_open()) {
-      file_stream_->close();
-      file_stream_ = std::nullopt;
+void Logger::write_batch(const std::string& batch) {
+  if (is_stdout_enabled_)
+    write_all(STDOUT_FILENO, batch);
+  const std::lock_guard lock(output_mutex_);
+  if (file_descriptor_ != -1)
+    write_all(file_descriptor_, batch);
+}
+
+void Logger::run_flush_thread() {
+  std::string batch;
+  std::string text;
+  while (true) {
+    while (batch.size() < BATCH_SIZE && try_dequeue(text)) {
+      // Records carry their own line breaks.
+      batch += text;
     }
+
+    const uint64_t dropped_records = dropped_records_.exchange(0);
+    if (dropped_records > 0)
+      batch += "Logger: " + std::to_string(dropped_records) +
+               " records dropped\n";
+
+    if (!batch.empty()) {
+      write_batch(batch);
+      batch.clear();
+      {
+        const std::lock_guard lock(flush_mutex_);
+        written_position_ = dequeue_position_;
+      }
+      written_cv_.notify_all();
+      continue;
+    }
+
+    std::unique_lock lock(flush_mutex_);
+    written_position_ = dequeue_position_;
+    written_cv_.notify_all();
+    if (should_terminate_)
+      return;
+    is_flush_thread_sleeping_.store(true);
+    // Checked after raising the flag, a producer that published before
+    // it would not have woken us up.
+    const Slot& slot = ring_[dequeue_position_ % RING_SIZE];
+    if (slot.sequence.load() != dequeue_position_ + 1)
+      flush_cv_.wait_for(lock, FLUSH_INTERVAL);
+    is_flush_thread_sleeping_.store(false);
+  }
+}
+
+Logger::~Logger() {
+  {
+    const std::lock_guard lock(flush_mutex_);
+    should_terminate_ = true;
+  }
+  flush_cv_.notify_one();
+  flush_thread_.join();
+  if (file_descriptor_ != -1)
+    ::close(file_descriptor_);
 }
 
 }  // namespace uni_cpp_practice
@@ -1,15 +1,20 @@
+#include <algorithm>
 #include <array>
-#include <chrono>
 #include <filesystem>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
+#include "bounded_queue.hpp"
+#include "date_time.hpp"
 #include "graph.hpp"
+#include "graph_archive.hpp"
 #include "graph_generation_controller.hpp"
 #include "graph_printer.hpp"
 #include "logger.hpp"
 
+using uni_cpp_practice::BoundedQueue;
+using uni_cpp_practice::GraphArchiveWriter;
 using Graph = uni_cpp_practice::Graph;
 using Edge = uni_cpp_practice::Edge;
 using GraphPrinter = uni_cpp_practice::GraphPrinter;
@@ -17,14 +22,6 @@ using GraphGenerator = uni_cpp_practice::GraphGenerator;
 using GraphGenerationController = uni_cpp_practice::GraphGenerationController;
 using Logger = uni_cpp_practice::Logger;
 
-std::string get_date_and_time() {
-  std::time_t now =
-      std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-  std::stringstream date_time_string;
-  date_time_string << std::put_time(std::localtime(&now), "%d/%m/%Y %T");
-  return date_time_string.str();
-}
-
 int handle_depth_input() {
   int max_depth = 0;
   std::cout << "Enter max_depth: ";
@@ -73,9 +70,13 @@ int handle_graphs_count_input() {
   return graphs_count;
 }
 
+// Called from the generator threads and the writer thread at once, the
+// time comes from the calling thread's cached second.
 void log_start(Logger& logger, const int graph_number) {
-  logger.log(get_date_and_time() + ": Graph " + std::to_string(graph_number) +
-             ", Generation Started\n");
+  std::string line;
+  uni_cpp_practice::date_time::append_date_time(line);
+  line += ": Graph " + std::to_string(graph_number) + ", Generation Started\n";
+  logger.log(std::move(line));
 }
 
 void log_depth(Logger& logger, const Graph& graph) {
@@ -99,8 +100,11 @@ void log_colors(Logger& logger, const Graph& graph) {
 }
 
 void log_end(Logger& logger, const Graph& graph, int graph_number) {
-  logger.log(get_date_and_time() + ": Graph " + std::to_string(graph_number) +
-             ", Generation Finished {  \n");
+  std::string line;
+  uni_cpp_practice::date_time::append_date_time(line);
+  line +=
+      ": Graph " + std::to_string(graph_number) + ", Generation Finished {  \n";
+  logger.log(std::move(line));
   logger.log("  depth: " + std::to_string(graph.depth()) + ",\n");
   logger.log("  vertices: " + std::to_string(graph.get_vertices().size()) +
              ", [");
@@ -111,15 +115,6 @@ void log_end(Logger& logger, const Graph& graph, int graph_number) {
   logger.log("}\n}\n");
 }
 
-void write_to_file(const GraphPrinter& graph_printer,
-                   const std::string& filename) {
-  std::ofstream jsonfile(filename, std::ios::out);
-  if (!jsonfile.is_open())
-    throw std::runtime_error("Error while opening the JSON file!");
-  jsonfile << graph_printer.print();
-  jsonfile.close();
-}
-
 int main() {
   const int threads_count = handle_threads_count_input();
   const int graphs_count = handle_graphs_count_input();
@@ -131,17 +126,30 @@ int main() {
   auto& logger = Logger::get_instance();
   std::filesystem::create_directory("./temp");
   logger.set_file("./temp/log.txt");
-  auto graphs = std::vector<Graph>();
-  graphs.reserve(graphs_count);
+  logger.log("Seed: " + std::to_string(params.seed) + "\n");
+
+  // Finished graphs go to a separate writer thread through a bounded queue,
+  // so generation only waits for the disk when the writer falls behind.
+  // They are all appended to one archive instead of a file per graph.
+  BoundedQueue<std::pair<int, Graph>> finished_graphs(
+      std::max(threads_count, 1));
+  GraphArchiveWriter archive("./temp/graphs.archive");
+  std::thread writer_thread([&logger, &finished_graphs, &archive, &params]() {
+    while (auto finished_graph = finished_graphs.pop()) {
+      const auto& [index, graph] = *finished_graph;
+      log_end(logger, graph, index);
+      const auto graph_printer = GraphPrinter(graph);
+      archive.write_graph(graph_printer.print(), index, params);
+    }
+  });
 
   generation_controller.generate(
       [&logger](int index) { log_start(logger, index); },
-      [&logger, &graphs](int index, Graph graph) {
-        log_end(logger, graph, index);
-        graphs.push_back(graph);
-        const auto graph_printer = GraphPrinter(graph);
-        write_to_file(graph_printer,
-                      "./temp/graph_" + std::to_string(index) + ".json");
+      [&finished_graphs](int index, Graph graph) {
+        finished_graphs.push({index, std::move(graph)});
       });
+  finished_graphs.close();
+  writer_thread.join();
+  archive.close();
   return 0;
 }
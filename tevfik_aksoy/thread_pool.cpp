@@ -0,0 +1,175 @@
+#include "thread_pool.hpp"
+#include <cassert>
+
+namespace {
+
+thread_local uni_cpp_practice::ThreadPool::Worker* current_worker = nullptr;
+
+}  // namespace
+
+namespace uni_cpp_practice {
+
+ThreadPool::ThreadPool(int threads_count) {
+  assert(threads_count > 0 && "Threads count must be positive!");
+  for (int i = 0; i < threads_count; i++)
+    workers_.emplace_back(*this, i);
+  for (auto& worker : workers_)
+    worker.start();
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    const std::lock_guard lock(mutex_sleep_);
+    should_terminate_ = true;
+  }
+  cv_sleep_.notify_all();
+  for (auto& worker : workers_)
+    worker.join();
+}
+
+ThreadPool::Worker* ThreadPool::get_current_worker() const {
+  if (current_worker == nullptr || &current_worker->get_thread_pool() != this)
+    return nullptr;
+  return current_worker;
+}
+
+void ThreadPool::submit(JobCallback job) {
+  if (Worker* const worker = get_current_worker(); worker != nullptr) {
+    worker->push_job(std::move(job));
+  } else {
+    const int index = next_worker_index_++ % get_threads_count();
+    workers_[index].push_job(std::move(job));
+  }
+  {
+    const std::lock_guard lock(mutex_sleep_);
+    pending_jobs_++;
+  }
+  cv_sleep_.notify_one();
+}
+
+std::optional<ThreadPool::JobCallback> ThreadPool::take_job() {
+  Worker* const worker = get_current_worker();
+  if (worker != nullptr) {
+    auto job = worker->pop_job();
+    if (job.has_value())
+      return job;
+  }
+
+  for (auto& victim : workers_) {
+    if (&victim == worker)
+      continue;
+    auto job = victim.steal_job();
+    if (job.has_value())
+      return job;
+  }
+  return std::nullopt;
+}
+
+bool ThreadPool::run_pending_job() {
+  const auto job = take_job();
+  if (!job.has_value())
+    return false;
+  pending_jobs_--;
+  job.value()();
+  return true;
+}
+
+void ThreadPool::notify_all() {
+  {
+    const std::lock_guard lock(mutex_sleep_);
+  }
+  cv_sleep_.notify_all();
+}
+
+void ThreadPool::run_worker(Worker& worker) {
+  current_worker = &worker;
+  while (true) {
+    if (run_pending_job())
+      continue;
+
+    std::unique_lock lock(mutex_sleep_);
+    cv_sleep_.wait(lock, [this]() {
+      return should_terminate_ || pending_jobs_ > 0;
+    });
+    if (should_terminate_ && pending_jobs_ == 0)
+      return;
+  }
+}
+
+void ThreadPool::Worker::start() {
+  assert(!thread_.joinable() && "Worker is already started!");
+  thread_ = std::thread([this]() { thread_pool_.run_worker(*this); });
+}
+
+void ThreadPool::Worker::join() {
+  if (thread_.joinable())
+    thread_.join();
+}
+
+void ThreadPool::Worker::push_job(JobCallback job) {
+  const std::lock_guard lock(mutex_jobs_);
+  jobs_.push_back(std::move(job));
+}
+
+std::optional<ThreadPool::JobCallback> ThreadPool::Worker::pop_job() {
+  const std::lock_guard lock(mutex_jobs_);
+  if (jobs_.empty())
+    return std::nullopt;
+  auto job = std::move(jobs_.front());
+  jobs_.pop_front();
+  return job;
+}
+
+std::optional<ThreadPool::JobCallback> ThreadPool::Worker::steal_job() {
+  const std::lock_guard lock(mutex_jobs_);
+  if (jobs_.empty())
+    return std::nullopt;
+  auto job = std::move(jobs_.back());
+  jobs_.pop_back();
+  return job;
+}
+
+void TaskGroup::run(ThreadPool::JobCallback job) {
+  state_->pending_jobs++;
+  {
+    const std::lock_guard lock(state_->mutex_jobs);
+    state_->jobs.push_back(std::move(job));
+  }
+  // Every pool job runs one group job, unless the waiter got to it first.
+  thread_pool_.submit([&thread_pool = thread_pool_, state = state_]() {
+    run_own_job(thread_pool, *state);
+  });
+}
+
+bool TaskGroup::run_own_job(ThreadPool& thread_pool, State& state) {
+  ThreadPool::JobCallback job;
+  {
+    const std::lock_guard lock(state.mutex_jobs);
+    if (state.jobs.empty())
+      return false;
+    job = std::move(state.jobs.front());
+    state.jobs.pop_front();
+  }
+  job();
+  if (--state.pending_jobs == 0)
+    thread_pool.notify_all();
+  return true;
+}
+
+void TaskGroup::wait() {
+  const bool is_worker = thread_pool_.get_current_worker() != nullptr;
+  while (state_->pending_jobs > 0) {
+    if (run_own_job(thread_pool_, *state_))
+      continue;
+    if (is_worker && thread_pool_.run_pending_job())
+      continue;
+
+    std::unique_lock lock(thread_pool_.mutex_sleep_);
+    thread_pool_.cv_sleep_.wait(lock, [this, is_worker]() {
+      return state_->pending_jobs == 0 ||
+             (is_worker && thread_pool_.pending_jobs_ > 0);
+    });
+  }
+}
+
+}  // namespace uni_cpp_practice